@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ThreadPool;
+
+// 单个桶的峰值信息（采样已混为单声道，范围 [-1, 1]）
+struct PeakBucket {
+    float min;
+    float max;
+    float rms;
+};
+
+// 整个文件的音频峰值概览：多分辨率金字塔，第 0 层每桶 kBaseBucketSamples 个采样，
+// 之后每层桶数减半。时间轴缩放时只需选层，无需重新计算
+class AudioPeaks {
+public:
+    static const int kBaseBucketSamples = 256;
+
+    AudioPeaks();
+    ~AudioPeaks();
+
+    AudioPeaks(const AudioPeaks&) = delete;
+    AudioPeaks& operator=(const AudioPeaks&) = delete;
+
+    // 在后台构建峰值概览，优先读取磁盘缓存。
+    // 分段解码使用自有线程池（不超过一半的核心），不与帧转换争用线程
+    void BuildAsync(const std::wstring& filename);
+    void Cancel();
+
+    bool IsReady() const { return ready.load(std::memory_order_acquire); }
+    int GetSampleRate() const { return sampleRate; }
+    double GetDuration() const { return sampleRate > 0 ? (double)totalSamples / sampleRate : 0.0; }
+    int GetLevelCount() const { return (int)levels.size(); }
+
+    // 选取每桶采样数不超过 samplesPerPixel 的最粗层级，bucketSamples 返回该层每桶采样数
+    const std::vector<PeakBucket>* GetLevel(double samplesPerPixel, int64_t* bucketSamples) const;
+
+private:
+    bool Build(const std::wstring& filename);
+    bool LoadCache(const std::filesystem::path& cachePath);
+    void SaveCache(const std::filesystem::path& cachePath) const;
+    void BuildLevels(std::vector<PeakBucket> baseLevel);
+
+    std::vector<std::vector<PeakBucket>> levels;
+    int sampleRate = 0;
+    int64_t totalSamples = 0;
+
+    // 源文件路径（UTF-8）、大小与修改时间，用于校验磁盘缓存
+    std::string sourcePath;
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+
+    std::unique_ptr<ThreadPool> decodePool;
+
+    std::thread builder;
+    std::atomic<bool> ready{ false };
+    std::atomic<bool> cancelled{ false };
+};
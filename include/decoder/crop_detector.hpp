@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+
+struct AVFrame;
+
+// 裁剪区域（像素）
+struct CropRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// 黑边检测：从四边向内扫描亮度平面，多帧取并集后得到稳定的裁剪区域。
+// 仅支持 8 位平面 YUV 格式，其余格式不裁剪
+class CropDetector {
+public:
+    void Reset();
+
+    // 送入一帧，返回该帧是否被采纳（全黑帧或不支持的格式不计入）
+    bool Feed(const AVFrame* frame);
+
+    // 对齐到色度子采样后的裁剪区域；尚无有效采样（含格式不支持）时为整帧
+    CropRect GetCrop() const;
+
+    int GetSampledFrames() const { return sampledFrames; }
+    // 亮度扫描累计耗时（微秒），不含调用方为取样所做的定位与解码
+    int64_t GetDetectMicros() const { return detectMicros; }
+
+private:
+    int frameWidth = 0;
+    int frameHeight = 0;
+    int alignX = 1;
+    int alignY = 1;
+
+    // 各帧内容区域的并集
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+
+    int sampledFrames = 0;
+    int64_t detectMicros = 0;
+};
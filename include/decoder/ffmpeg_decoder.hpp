@@ -2,25 +2,62 @@
 #include <cstdint>
 #include <string>
 #include <memory>
+#include "decoder/crop_detector.hpp"
+#include "decoder/frame_converter.hpp"
+#include "decoder/subtitle_track.hpp"
 
 struct AVFormatContext;
 struct AVCodecContext;
 struct AVFrame;
 struct AVPacket;
+class ThreadPool;
 
 class FFmpegDecoder {
 public:
-    FFmpegDecoder() = default;
+    // pool 用于并行颜色转换，为空时单线程转换
+    explicit FFmpegDecoder(ThreadPool* pool = nullptr);
     ~FFmpegDecoder();
 
     bool OpenFile(const std::wstring& filename);
-    bool DecodeFirstFrame(uint8_t** frameData, int* width, int* height);
+    // 解码第一帧并检测黑边，width/height 返回裁剪后的输出尺寸
+    bool DecodeFirstFrame(int* width, int* height);
+    // 解码下一帧替换当前帧，到达文件末尾时返回 false
+    bool DecodeFrame();
+    // 将当前解码帧转换为 BGRA，直接写入 dest（行距为 destPitch 字节、destWidth x destHeight 像素）；
+    // 输出尺寸与目标不符时返回 false，不写入
+    bool ConvertFrame(uint8_t* dest, int destPitch, int destWidth, int destHeight);
     void Cleanup();
 
+    const FrameConverter& GetConverter() const { return converter; }
+    CropRect GetCrop() const { return crop; }
+
+    // 当前帧的显示时间（秒）及完整帧尺寸
+    double GetFrameTime() const;
+    int GetFrameWidth() const;
+    int GetFrameHeight() const;
+
+    // 解复用过程中顺带解码得到的字幕事件
+    const SubtitleTrack& GetSubtitles() const { return subtitles; }
+
 private:
+    bool DecodeNextFrame(AVFrame* target);
+    void DetectCrop();
+    void OpenSubtitleStream();
+    void DecodeSubtitlePacket();
+    void FlushDecoders();
+
     AVFormatContext* formatContext = nullptr;
     AVCodecContext* codecContext = nullptr;
     AVFrame* frame = nullptr;
     AVPacket* packet = nullptr;
+    FrameConverter converter;
+    CropDetector cropDetector;
+    CropRect crop;  // 实际使用的输出区域，检测无结果时为整帧
     int videoStreamIndex = -1;
+    bool packetPending = false;  // packet 因解码器返回 EAGAIN 尚未送入
+    bool draining = false;       // 已到文件末尾并送入空包，正在取出剩余帧
+
+    AVCodecContext* subtitleCodecContext = nullptr;
+    int subtitleStreamIndex = -1;
+    SubtitleTrack subtitles;
 };
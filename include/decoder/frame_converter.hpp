@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "decoder/crop_detector.hpp"
+
+struct AVBufferRef;
+struct AVFrame;
+struct SwsContext;
+class ThreadPool;
+
+// 将解码帧并行转换为 BGRA。
+// 8 位 4:4:4 与偶数高度的 8 位 4:2:0/4:2:2 按偶数行对齐的水平条带切分，在线程池上各自转换；
+// 其余格式独立转换的条带会在边界产生接缝，改用 swscale 自带的切片多线程。
+// 后者的线程由 swscale 另行创建，数量与线程池相同：多出一组常驻线程的栈内存，
+// 但它们只在 Convert 阻塞调用方期间运行，此时线程池空闲，不会与池内线程争用 CPU
+class FrameConverter {
+public:
+    explicit FrameConverter(ThreadPool* pool = nullptr);
+    ~FrameConverter();
+
+    FrameConverter(const FrameConverter&) = delete;
+    FrameConverter& operator=(const FrameConverter&) = delete;
+
+    // 只转换 crop 指定的区域；宽高为 0 时转换整帧
+    void SetCrop(const CropRect& rect) { crop = rect; }
+
+    // 将 frame 转换为 BGRA，直接写入 dest（行距为 destPitch 字节、destWidth x destHeight 像素）。
+    // 裁剪区域超出帧、或输出区域尺寸与目标不一致时返回 false 且不写入
+    bool Convert(const AVFrame* frame, uint8_t* dest, int destPitch, int destWidth, int destHeight);
+    void Cleanup();
+
+    int GetBandCount() const { return (int)bands.size(); }
+    // 当前格式是否交给 swscale 自带的切片多线程
+    bool UsesSwscaleThreads() const { return swscaleThreads; }
+
+private:
+    struct Band {
+        int y = 0;
+        int height = 0;
+        SwsContext* swsContext = nullptr;
+    };
+
+    bool Prepare(int width, int height, int format);
+    bool ConvertWithSwscaleThreads(const AVFrame* frame, const CropRect& region, uint8_t* dest, int destPitch);
+
+    ThreadPool* threadPool = nullptr;
+    CropRect crop;
+    std::vector<Band> bands;
+    bool swscaleThreads = false;
+    AVFrame* sourceView = nullptr;  // swscale 多线程路径使用的源/目标帧描述，复用以免每帧分配
+    AVFrame* targetView = nullptr;
+    AVBufferRef* borrowedBuffer = nullptr;  // 两个视图共用的借用引用，不持有任何内存
+    int bandWidth = 0;
+    int bandSourceHeight = 0;
+    int bandFormat = -1;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+struct AVSubtitle;
+
+// 位图字幕的一个区域，像素为预乘前的 BGRA（与调色板 0xAARRGGBB 的内存布局一致）
+struct SubtitleBitmap {
+    int x = 0;                // 在字幕画布上的位置与显示尺寸
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    int pixelWidth = 0;       // pixels 的实际尺寸；超大位图解码时已缩小，可能小于显示尺寸
+    int pixelHeight = 0;
+    std::vector<uint32_t> pixels;
+};
+
+// 一条字幕事件，时间单位为秒
+struct SubtitleEvent {
+    uint64_t id = 0;          // 唯一编号，供渲染缓存索引
+    double start = 0.0;
+    double end = 0.0;         // 未知结束时间时为无穷大，直到下一条清屏事件
+    std::string text;         // 文本字幕（UTF-8，已去除 ASS 样式标签）
+    std::vector<SubtitleBitmap> bitmaps;
+    int canvasWidth = 0;      // 位图坐标所在的画布尺寸，0 表示与视频相同
+    int canvasHeight = 0;
+};
+
+// 已解码字幕事件的缓存，按开始时间排序，可按时间查询
+class SubtitleTrack {
+public:
+    // 位图像素的最大边长，与字幕图集边长一致；更大的位图在加入时等比缩小
+    static const int kMaxBitmapSize = 2048;
+
+    // 加入一条解码得到的字幕；time 为该字幕的起始时间（秒）
+    void AddSubtitle(const AVSubtitle& subtitle, double time, double packetDuration,
+                     int canvasWidth, int canvasHeight);
+    void Clear();
+
+    // 收集 time 时刻应显示的事件，out 在调用前会被清空
+    void GetActiveEvents(double time, std::vector<const SubtitleEvent*>& out) const;
+
+    size_t GetEventCount() const { return events.size(); }
+
+private:
+    std::vector<SubtitleEvent> events;
+    uint64_t nextId = 1;
+    double longestDuration = 0.0;  // 已知结束时间的事件中最长的持续时间
+    double earliestOpenStart = std::numeric_limits<double>::infinity();  // 未结束事件中最早的开始时间
+};
@@ -3,6 +3,7 @@
 #include <d3d11.h>
 #include <directxmath.h>
 #include <memory>
+#include "renderer/frame_writer.hpp"
 
 struct Vertex {
     DirectX::XMFLOAT3 pos;
@@ -15,13 +16,18 @@ public:
     ~D3D11Renderer();
 
     bool Initialize(HWND hwnd, int width, int height);
-    void Render(const uint8_t* frameData);
+    using FrameWriter = ::FrameWriter;
+
+    // writeFrame 为空时沿用纹理中已有的帧，不做上传；上传失败时返回 false
+    bool Render(const FrameWriter& writeFrame);
     void Present(int syncInterval);
     void Resize(int width, int height);
     void Cleanup();
 
     ID3D11Device* GetDevice() const { return d3dDevice; }
     ID3D11DeviceContext* GetContext() const { return d3dContext; }
+    // 最近一次渲染时视频在窗口中的区域
+    const D3D11_VIEWPORT& GetVideoViewport() const { return videoViewport; }
 
 private:
     bool CreateShaders();
@@ -39,8 +45,10 @@ private:
     ID3D11Buffer* indexBuffer = nullptr;
     ID3D11InputLayout* inputLayout = nullptr;
 
+    bool textureValid = false;  // 纹理中是否有完整的帧
     int textureWidth = 0;
     int textureHeight = 0;
+    D3D11_VIEWPORT videoViewport = {};
 
     ID3D11Device* d3dDevice = nullptr;
     ID3D11DeviceContext* d3dContext = nullptr;
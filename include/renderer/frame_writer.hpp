@@ -0,0 +1,7 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// 向映射后的纹理内存写入一帧：dest 为纹理首地址，pitch 为 RowPitch，
+// width/height 为纹理像素尺寸，写入不得超出该范围；尺寸不符或失败时返回 false
+using FrameWriter = std::function<bool(uint8_t* dest, int pitch, int width, int height)>;
@@ -3,8 +3,13 @@
 #include "imgui_impl_win32.h"
 #include "imgui_impl_dx11.h"
 #include "renderer/d3d11_renderer.hpp"
+#include "ui/subtitle_overlay.hpp"
+#include "utils/perf_counters.hpp"
 #include <Windows.h>
 
+class AudioPeaks;
+class FFmpegDecoder;
+
 class PlayerUI {
 public:
     PlayerUI() = default;
@@ -13,10 +18,31 @@ public:
     bool Initialize(HWND hwnd, D3D11Renderer* renderer);
     void Render();
     void Shutdown();
+
+    // 设置时间轴使用的音频峰值概览，可在构建完成前设置
+    void SetAudioPeaks(const AudioPeaks* peaks) { audioPeaks = peaks; }
+    // 设置字幕来源，按解码器当前帧时间叠加字幕
+    void SetDecoder(const FFmpegDecoder* source) { decoder = source; }
     
     // 处理窗口消息
     static LRESULT HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
 private:
+    void RenderSubtitles();
+    void RenderTimeline();
+    void RenderStats();
+
     bool initialized = false;
+    D3D11Renderer* videoRenderer = nullptr;
+    const FFmpegDecoder* decoder = nullptr;
+    SubtitleOverlay subtitleOverlay;
+    std::vector<const SubtitleEvent*> activeSubtitles;  // 每帧复用
+    const AudioPeaks* audioPeaks = nullptr;
+    float timelineZoom = 1.0f;
+    float timelineOffset = 0.0f;  // 可见区域起点（秒）
+
+    // 统计窗口：每隔若干帧取一次快照，显示区间内的每帧平均值
+    PerfSnapshot statsBase;
+    PerfSnapshot statsCurrent;
+    PerfSnapshot statsPrevious;
 };
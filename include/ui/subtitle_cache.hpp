@@ -0,0 +1,80 @@
+#pragma once
+#include "decoder/subtitle_track.hpp"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// 字幕渲染缓存：位图按行（shelf）装入固定大小的图集，文本按行排版一次并保存字形四边形，
+// 之后每帧只查表、回放四边形。与图形 API 无关，上传与文字排版由调用方提供
+class SubtitleCache {
+public:
+    // 图集边长（像素），与 SubtitleTrack::kMaxBitmapSize 一致，单个位图总能装入空图集
+    static const int kAtlasSize = SubtitleTrack::kMaxBitmapSize;
+
+    struct CachedBitmap {
+        float u0 = 0.0f;
+        float v0 = 0.0f;
+        float u1 = 0.0f;
+        float v1 = 0.0f;
+    };
+
+    // 一个字形的四边形：位置为排版字号下相对行起点（左上角）的坐标，UV 位于字体图集中
+    struct GlyphQuad {
+        float x0 = 0.0f;
+        float y0 = 0.0f;
+        float x1 = 0.0f;
+        float y1 = 0.0f;
+        float u0 = 0.0f;
+        float v0 = 0.0f;
+        float u1 = 0.0f;
+        float v1 = 0.0f;
+    };
+
+    struct CachedLine {
+        size_t begin = 0;   // 在事件文本中的字节区间
+        size_t end = 0;
+        float width = 0.0f; // 排版函数返回的宽度
+        std::vector<GlyphQuad> glyphs;
+    };
+
+    struct Entry {
+        std::vector<CachedBitmap> bitmaps;  // 与事件的 bitmaps 一一对应
+        std::vector<CachedLine> lines;
+        bool bitmapsFailed = false;         // 清空图集后仍装不下，只绘制文本，不再重试
+        uint64_t lastUsedFrame = 0;
+    };
+
+    // 把位图像素写入图集 (x, y) 处
+    using UploadFunction = std::function<void(const SubtitleBitmap& bitmap, int x, int y)>;
+    // 排版 [begin, end) 文本：把可见字形追加到 glyphs，返回行宽
+    using LayoutFunction = std::function<float(const char* begin, const char* end, std::vector<GlyphQuad>& glyphs)>;
+
+    void SetUploadFunction(UploadFunction function) { upload = std::move(function); }
+    void SetLayoutFunction(LayoutFunction function) { layout = std::move(function); }
+
+    // 为一帧的事件取得缓存条目，entries 与 events 一一对应。
+    // 图集装满时最多清空一次并重建本帧条目；命中/未命中只统计最终结果
+    void Prepare(const std::vector<const SubtitleEvent*>& events, std::vector<const Entry*>& entries);
+    void Clear();
+
+    size_t GetEntryCount() const { return cache.size(); }
+    uint64_t GetAtlasResets() const { return atlasResets; }
+
+private:
+    bool CacheEvent(const SubtitleEvent& event, Entry& entry);
+    bool AllocateAtlas(int width, int height, int* x, int* y);
+    bool IsAtlasEmpty() const { return shelfX == 0 && shelfY == 0 && shelfHeight == 0; }
+    void ResetAtlas();
+
+    UploadFunction upload;
+    LayoutFunction layout;
+
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    uint64_t atlasResets = 0;
+
+    std::unordered_map<uint64_t, Entry> cache;
+    uint64_t frameIndex = 0;
+};
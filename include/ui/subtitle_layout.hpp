@@ -0,0 +1,25 @@
+#pragma once
+#include "decoder/crop_detector.hpp"
+#include "decoder/subtitle_track.hpp"
+
+// 视频在窗口中的显示区域（像素）
+struct SubtitleViewport {
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+};
+
+struct SubtitleRect {
+    float x0 = 0.0f;
+    float y0 = 0.0f;
+    float x1 = 0.0f;
+    float y1 = 0.0f;
+};
+
+// 位图字幕在窗口中的绘制区域：画布坐标映射到完整帧，再减去裁剪偏移映射到 viewport。
+// 落在已裁掉的黑边里的位图（如放在下黑边的 PGS 字幕）平移回 viewport 内，
+// 比 viewport 还大的位图以中心为基准等比缩小
+SubtitleRect PlaceSubtitleBitmap(const SubtitleBitmap& bitmap, const SubtitleEvent& event,
+                                 const SubtitleViewport& viewport, const CropRect& crop,
+                                 int frameWidth, int frameHeight);
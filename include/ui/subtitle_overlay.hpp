@@ -0,0 +1,38 @@
+#pragma once
+#include "imgui.h"
+#include "decoder/crop_detector.hpp"
+#include "decoder/subtitle_track.hpp"
+#include "ui/subtitle_cache.hpp"
+#include "ui/subtitle_layout.hpp"
+#include <d3d11.h>
+#include <vector>
+
+// 字幕叠加层：位图字幕上传到纹理图集，文本字幕使用 ImGui 字体图集，
+// 每条事件只在首次出现时排版/上传（由 SubtitleCache 管理），之后每帧直接以批量四边形绘制
+class SubtitleOverlay {
+public:
+    SubtitleOverlay() = default;
+    ~SubtitleOverlay();
+
+    bool Initialize(ID3D11Device* device, ID3D11DeviceContext* context);
+    void Shutdown();
+
+    void SetFont(ImFont* subtitleFont) { font = subtitleFont; }
+
+    // 把当前事件绘制到 drawList。viewport 为视频在窗口中的区域，
+    // crop 为视频显示的裁剪区域，frameWidth/frameHeight 为完整帧尺寸
+    void Render(ImDrawList* drawList, const std::vector<const SubtitleEvent*>& events,
+                const D3D11_VIEWPORT& viewport, const CropRect& crop, int frameWidth, int frameHeight);
+
+private:
+    void UploadBitmap(const SubtitleBitmap& bitmap, int x, int y);
+
+    ID3D11Device* d3dDevice = nullptr;
+    ID3D11DeviceContext* d3dContext = nullptr;
+    ID3D11Texture2D* atlasTexture = nullptr;
+    ID3D11ShaderResourceView* atlasView = nullptr;
+    ImFont* font = nullptr;
+
+    SubtitleCache cache;
+    std::vector<const SubtitleCache::Entry*> frameEntries;  // 每帧复用，避免分配
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// 进程级性能计数器：分配次数与各阶段拷贝字节数，供 PlayerUI 显示
+struct PerfCounters {
+    // 稳态播放时每帧允许的 C++ 堆分配次数：PlayerUI 超出时标红，steady_state_alloc_test 以此断言
+    static const uint64_t kMaxHeapAllocationsPerFrame = 0;
+
+    // C++ 堆分配（全局 operator new）
+    std::atomic<uint64_t> heapAllocations{ 0 };
+    std::atomic<uint64_t> heapBytes{ 0 };
+
+    // FFmpeg 解码器获取的帧缓冲（get_buffer2）
+    std::atomic<uint64_t> frameBuffers{ 0 };
+    std::atomic<uint64_t> frameBufferBytes{ 0 };
+
+    // 各阶段写出的字节数
+    std::atomic<uint64_t> convertedBytes{ 0 };   // 颜色转换写入目标内存
+    std::atomic<uint64_t> uploadedBytes{ 0 };    // 渲染器映射纹理的字节数
+
+    std::atomic<uint64_t> renderedFrames{ 0 };
+
+    // 黑边裁剪：每帧少转换/上传的字节数；检测总耗时（含取样的定位与解码）及其中亮度扫描的耗时
+    std::atomic<uint64_t> cropSavedBytes{ 0 };
+    std::atomic<uint64_t> cropDetectMicros{ 0 };
+    std::atomic<uint64_t> cropScanMicros{ 0 };
+
+    // 字幕叠加：缓存命中/未命中次数，以及最近一帧的叠加耗时
+    std::atomic<uint64_t> subtitleCacheHits{ 0 };
+    std::atomic<uint64_t> subtitleCacheMisses{ 0 };
+    std::atomic<uint64_t> subtitleOverlayMicros{ 0 };
+};
+
+// 计数器的普通值拷贝，便于求差
+struct PerfSnapshot {
+    uint64_t heapAllocations = 0;
+    uint64_t heapBytes = 0;
+    uint64_t frameBuffers = 0;
+    uint64_t frameBufferBytes = 0;
+    uint64_t convertedBytes = 0;
+    uint64_t uploadedBytes = 0;
+    uint64_t renderedFrames = 0;
+    uint64_t cropSavedBytes = 0;
+    uint64_t cropDetectMicros = 0;
+    uint64_t cropScanMicros = 0;
+    uint64_t subtitleCacheHits = 0;
+    uint64_t subtitleCacheMisses = 0;
+    uint64_t subtitleOverlayMicros = 0;
+};
+
+PerfCounters& GetPerfCounters();
+PerfSnapshot TakePerfSnapshot();
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常驻工作线程池，供帧转换等并行任务复用，避免每帧创建线程
+class ThreadPool {
+public:
+    // threadCount 为 0 时使用硬件线程数
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int GetThreadCount() const { return (unsigned int)workers.size(); }
+
+    // 并行执行 fn(0) ... fn(count - 1)，调用线程也参与，全部完成后返回。
+    // 批次状态是池的成员，调用本身不分配内存；多个线程的调用依次执行，
+    // fn 内不能再对同一个池调用 ParallelFor
+    void ParallelFor(int count, const std::function<void(int)>& fn);
+
+private:
+    void WorkerLoop();
+    void DrainBatch(const std::function<void(int)>& fn, int count);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable taskCondition;
+    bool stopping = false;
+
+    // 当前 ParallelFor 批次；除 batchNext/batchRemaining 外均由 mutex 保护
+    std::mutex batchMutex;  // 串行化 ParallelFor 调用
+    const std::function<void(int)>* batchFn = nullptr;
+    int batchCount = 0;
+    int batchSlots = 0;     // 还可加入本批次的工作线程数
+    int batchHelpers = 0;   // 正在执行本批次的工作线程数
+    std::atomic<int> batchNext{ 0 };
+    std::atomic<int> batchRemaining{ 0 };
+    std::condition_variable batchDone;
+};
@@ -0,0 +1,5 @@
+#pragma once
+#include <string>
+
+// 宽字符串转 UTF-8（FFmpeg 的文件名参数使用 UTF-8）
+std::string ToUtf8(const std::wstring& text);
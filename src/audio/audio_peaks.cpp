@@ -0,0 +1,449 @@
+#include "audio/audio_peaks.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/utf8.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PEAKS_USE_SSE2 1
+#endif
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+#include <libswresample/swresample.h>
+}
+
+namespace {
+
+const uint32_t kCacheMagic = 0x4B505056; // "VPPK"
+const uint32_t kCacheVersion = 2;
+
+// 缓存目录的总大小上限，超出时按最近使用时间淘汰
+const uint64_t kMaxCacheBytes = 256ull * 1024 * 1024;
+
+// 每段至少覆盖的秒数，段太短时重复打开文件和寻址的开销占比过高
+const int kMinSegmentSeconds = 10;
+
+// 第 0 层累加器：rms 在全部采样归并完后再开方
+struct BucketAccumulator {
+    float min = FLT_MAX;
+    float max = -FLT_MAX;
+    double sumSquares = 0.0;
+    int count = 0;
+};
+
+// 对一段连续采样求 min/max/平方和
+void ReduceSamples(const float* samples, int count, float* outMin, float* outMax, double* outSumSquares) {
+    float minValue = FLT_MAX;
+    float maxValue = -FLT_MAX;
+    float sumSquares = 0.0f;
+    int i = 0;
+
+#ifdef PEAKS_USE_SSE2
+    __m128 vmin = _mm_set1_ps(FLT_MAX);
+    __m128 vmax = _mm_set1_ps(-FLT_MAX);
+    __m128 vsum = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(samples + i);
+        vmin = _mm_min_ps(vmin, v);
+        vmax = _mm_max_ps(vmax, v);
+        vsum = _mm_add_ps(vsum, _mm_mul_ps(v, v));
+    }
+    alignas(16) float lanes[3][4];
+    _mm_store_ps(lanes[0], vmin);
+    _mm_store_ps(lanes[1], vmax);
+    _mm_store_ps(lanes[2], vsum);
+    for (int lane = 0; lane < 4; lane++) {
+        minValue = std::min(minValue, lanes[0][lane]);
+        maxValue = std::max(maxValue, lanes[1][lane]);
+        sumSquares += lanes[2][lane];
+    }
+#endif
+
+    for (; i < count; i++) {
+        minValue = std::min(minValue, samples[i]);
+        maxValue = std::max(maxValue, samples[i]);
+        sumSquares += samples[i] * samples[i];
+    }
+
+    *outMin = minValue;
+    *outMax = maxValue;
+    *outSumSquares = sumSquares;
+}
+
+// 删除最久未使用的缓存文件，直到目录总大小不超过上限；keep 为刚写入的文件，不参与淘汰
+void TrimCacheDirectory(const std::filesystem::path& cacheDir, const std::filesystem::path& keep) {
+    struct CacheFile {
+        std::filesystem::path path;
+        std::filesystem::file_time_type time;
+        uint64_t size;
+    };
+
+    std::error_code error;
+    std::vector<CacheFile> files;
+    uint64_t totalBytes = 0;
+    for (std::filesystem::directory_iterator it(cacheDir, error), end; !error && it != end; it.increment(error)) {
+        if (it->path().extension() != L".peaks") continue;
+        std::error_code fileError;
+        uint64_t size = it->file_size(fileError);
+        if (fileError) continue;
+        totalBytes += size;
+        files.push_back({ it->path(), it->last_write_time(fileError), size });
+    }
+    if (totalBytes <= kMaxCacheBytes) return;
+
+    std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) {
+        return a.time < b.time;
+    });
+    for (const CacheFile& file : files) {
+        if (totalBytes <= kMaxCacheBytes) break;
+        if (file.path == keep) continue;
+        if (std::filesystem::remove(file.path, error)) {
+            totalBytes -= file.size;
+        }
+    }
+}
+
+// 解码 [startSample, endSample) 范围内的音频，写入对应的第 0 层桶。
+// 段边界对齐到桶大小，因此各段写入的桶互不重叠
+bool DecodeSegment(const std::string& filename, int64_t startSample, int64_t endSample,
+                   std::vector<BucketAccumulator>& buckets, const std::atomic<bool>& cancelled) {
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, filename.c_str(), NULL, NULL) < 0) {
+        return false;
+    }
+
+    AVCodecContext* codecContext = nullptr;
+    SwrContext* swrContext = nullptr;
+    AVPacket* packet = nullptr;
+    AVFrame* frame = nullptr;
+    std::vector<float> mono;
+    bool ok = false;
+
+    do {
+        if (avformat_find_stream_info(formatContext, NULL) < 0) break;
+
+        const AVCodec* codec = nullptr;
+        int audioStreamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, &codec, 0);
+        if (audioStreamIndex < 0 || !codec) break;
+
+        // 只解复用音频包
+        for (unsigned int i = 0; i < formatContext->nb_streams; i++) {
+            if ((int)i != audioStreamIndex) {
+                formatContext->streams[i]->discard = AVDISCARD_ALL;
+            }
+        }
+
+        AVStream* stream = formatContext->streams[audioStreamIndex];
+        codecContext = avcodec_alloc_context3(codec);
+        avcodec_parameters_to_context(codecContext, stream->codecpar);
+        if (avcodec_open2(codecContext, codec, NULL) < 0) break;
+
+        int sampleRate = codecContext->sample_rate;
+        AVRational sampleTimeBase = { 1, sampleRate };
+        int64_t streamStart = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+
+        AVChannelLayout monoLayout = AV_CHANNEL_LAYOUT_MONO;
+        if (swr_alloc_set_opts2(&swrContext, &monoLayout, AV_SAMPLE_FMT_FLT, sampleRate,
+                                &codecContext->ch_layout, codecContext->sample_fmt, sampleRate,
+                                0, NULL) < 0 || swr_init(swrContext) < 0) {
+            break;
+        }
+
+        if (startSample > 0) {
+            int64_t seekTarget = streamStart + av_rescale_q(startSample, sampleTimeBase, stream->time_base);
+            av_seek_frame(formatContext, audioStreamIndex, seekTarget, AVSEEK_FLAG_BACKWARD);
+        }
+
+        packet = av_packet_alloc();
+        frame = av_frame_alloc();
+        int64_t nextSample = -1;
+        bool reachedEnd = false;
+
+        while (!reachedEnd && !cancelled.load() && av_read_frame(formatContext, packet) >= 0) {
+            if (packet->stream_index == audioStreamIndex &&
+                avcodec_send_packet(codecContext, packet) >= 0) {
+                while (avcodec_receive_frame(codecContext, frame) == 0) {
+                    // 以时间戳定位采样位置，缺失时间戳时顺延上一帧
+                    int64_t position = nextSample;
+                    if (frame->best_effort_timestamp != AV_NOPTS_VALUE) {
+                        position = av_rescale_q(frame->best_effort_timestamp - streamStart,
+                                                stream->time_base, sampleTimeBase);
+                    }
+                    if (position < 0) position = std::max<int64_t>(nextSample, 0);
+                    nextSample = position + frame->nb_samples;
+
+                    if (position >= endSample) {
+                        reachedEnd = true;
+                        break;
+                    }
+                    if (nextSample <= startSample) continue;
+
+                    mono.resize(frame->nb_samples);
+                    uint8_t* output[1] = { (uint8_t*)mono.data() };
+                    int converted = swr_convert(swrContext, output, frame->nb_samples,
+                                                (const uint8_t**)frame->extended_data, frame->nb_samples);
+                    if (converted <= 0) continue;
+
+                    // 截取落在本段内的部分，并按桶边界切块归并
+                    int64_t first = std::max(position, startSample);
+                    int64_t last = std::min(position + converted, endSample);
+                    while (first < last) {
+                        int64_t bucketIndex = first / AudioPeaks::kBaseBucketSamples;
+                        int64_t bucketEnd = (bucketIndex + 1) * AudioPeaks::kBaseBucketSamples;
+                        int count = (int)(std::min(bucketEnd, last) - first);
+                        if (bucketIndex >= (int64_t)buckets.size()) break;
+
+                        float minValue, maxValue;
+                        double sumSquares;
+                        ReduceSamples(mono.data() + (first - position), count, &minValue, &maxValue, &sumSquares);
+
+                        BucketAccumulator& bucket = buckets[bucketIndex];
+                        bucket.min = std::min(bucket.min, minValue);
+                        bucket.max = std::max(bucket.max, maxValue);
+                        bucket.sumSquares += sumSquares;
+                        bucket.count += count;
+                        first += count;
+                    }
+                }
+            }
+            av_packet_unref(packet);
+        }
+
+        ok = !cancelled.load();
+    } while (false);
+
+    if (frame) av_frame_free(&frame);
+    if (packet) av_packet_free(&packet);
+    if (swrContext) swr_free(&swrContext);
+    if (codecContext) avcodec_free_context(&codecContext);
+    avformat_close_input(&formatContext);
+    return ok;
+}
+
+} // namespace
+
+AudioPeaks::AudioPeaks() {
+    // 帧转换使用全部核心，这里只占一半，避免后台构建拖慢播放
+    unsigned threadCount = std::thread::hardware_concurrency() / 2;
+    decodePool = std::make_unique<ThreadPool>(std::max(1u, threadCount));
+}
+
+AudioPeaks::~AudioPeaks() {
+    Cancel();
+}
+
+void AudioPeaks::BuildAsync(const std::wstring& filename) {
+    Cancel();
+    cancelled = false;
+    ready = false;
+
+    builder = std::thread([this, filename]() {
+        if (Build(filename)) {
+            ready.store(true, std::memory_order_release);
+        }
+    });
+}
+
+void AudioPeaks::Cancel() {
+    cancelled = true;
+    if (builder.joinable()) {
+        builder.join();
+    }
+}
+
+const std::vector<PeakBucket>* AudioPeaks::GetLevel(double samplesPerPixel, int64_t* bucketSamples) const {
+    if (!IsReady() || levels.empty()) return nullptr;
+
+    int level = 0;
+    while (level + 1 < (int)levels.size() &&
+           (double)((int64_t)kBaseBucketSamples << (level + 1)) <= samplesPerPixel) {
+        level++;
+    }
+
+    if (bucketSamples) *bucketSamples = (int64_t)kBaseBucketSamples << level;
+    return &levels[level];
+}
+
+bool AudioPeaks::Build(const std::wstring& filename) {
+    std::error_code error;
+    sourcePath = ToUtf8(filename);
+    sourceSize = std::filesystem::file_size(filename, error);
+    sourceTime = std::filesystem::last_write_time(filename, error).time_since_epoch().count();
+
+    // 缓存文件名由路径、大小和修改时间共同决定；哈希可能碰撞，文件头里另存路径校验
+    std::filesystem::path cacheDir = std::filesystem::temp_directory_path(error) / L"videoplayer-dx11-win32";
+    size_t key = std::hash<std::wstring>()(filename) ^ (std::hash<uint64_t>()(sourceSize) << 1) ^
+                 (std::hash<int64_t>()(sourceTime) << 2);
+    std::filesystem::path cachePath = cacheDir / (std::to_wstring(key) + L".peaks");
+
+    if (LoadCache(cachePath)) {
+        return true;
+    }
+
+    // 读取音频流参数，确定总采样数
+    const std::string& utf8Filename = sourcePath;
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, utf8Filename.c_str(), NULL, NULL) < 0) {
+        return false;
+    }
+    int audioStreamIndex = -1;
+    if (avformat_find_stream_info(formatContext, NULL) >= 0) {
+        audioStreamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, NULL, 0);
+    }
+    if (audioStreamIndex < 0) {
+        avformat_close_input(&formatContext);
+        return false;
+    }
+
+    AVStream* stream = formatContext->streams[audioStreamIndex];
+    sampleRate = stream->codecpar->sample_rate;
+    AVRational sampleTimeBase = { 1, sampleRate };
+    if (stream->duration != AV_NOPTS_VALUE) {
+        totalSamples = av_rescale_q(stream->duration, stream->time_base, sampleTimeBase);
+    } else if (formatContext->duration != AV_NOPTS_VALUE) {
+        totalSamples = av_rescale_q(formatContext->duration, AVRational{ 1, AV_TIME_BASE }, sampleTimeBase);
+    }
+    avformat_close_input(&formatContext);
+
+    if (sampleRate <= 0 || totalSamples <= 0) {
+        return false;
+    }
+
+    int64_t bucketCount = (totalSamples + kBaseBucketSamples - 1) / kBaseBucketSamples;
+    std::vector<BucketAccumulator> buckets((size_t)bucketCount);
+
+    // 按时间切分为若干段，段边界对齐到桶
+    int64_t minSegmentBuckets = (int64_t)kMinSegmentSeconds * sampleRate / kBaseBucketSamples + 1;
+    int segmentCount = (int)decodePool->GetThreadCount() * 2;
+    segmentCount = (int)std::max<int64_t>(1, std::min<int64_t>(segmentCount, bucketCount / minSegmentBuckets));
+
+    std::atomic<bool> failed{ false };
+    auto decodeSegment = [&](int index) {
+        int64_t firstBucket = bucketCount * index / segmentCount;
+        int64_t lastBucket = bucketCount * (index + 1) / segmentCount;
+        int64_t startSample = firstBucket * kBaseBucketSamples;
+        int64_t endSample = (index == segmentCount - 1) ? INT64_MAX : lastBucket * kBaseBucketSamples;
+        if (!DecodeSegment(utf8Filename, startSample, endSample, buckets, cancelled)) {
+            failed = true;
+        }
+    };
+
+    decodePool->ParallelFor(segmentCount, decodeSegment);
+    if (failed.load() || cancelled.load()) {
+        return false;
+    }
+
+    std::vector<PeakBucket> baseLevel((size_t)bucketCount);
+    for (size_t i = 0; i < baseLevel.size(); i++) {
+        const BucketAccumulator& bucket = buckets[i];
+        if (bucket.count == 0) {
+            baseLevel[i] = { 0.0f, 0.0f, 0.0f };
+        } else {
+            baseLevel[i] = { bucket.min, bucket.max, (float)std::sqrt(bucket.sumSquares / bucket.count) };
+        }
+    }
+    BuildLevels(std::move(baseLevel));
+
+    std::filesystem::create_directories(cacheDir, error);
+    SaveCache(cachePath);
+    TrimCacheDirectory(cacheDir, cachePath);
+    return true;
+}
+
+void AudioPeaks::BuildLevels(std::vector<PeakBucket> baseLevel) {
+    levels.clear();
+    levels.push_back(std::move(baseLevel));
+
+    // 每层两两合并，直到只剩一个桶
+    while (levels.back().size() > 1) {
+        const std::vector<PeakBucket>& previous = levels.back();
+        std::vector<PeakBucket> next((previous.size() + 1) / 2);
+        for (size_t i = 0; i < next.size(); i++) {
+            const PeakBucket& a = previous[i * 2];
+            if (i * 2 + 1 < previous.size()) {
+                const PeakBucket& b = previous[i * 2 + 1];
+                next[i].min = std::min(a.min, b.min);
+                next[i].max = std::max(a.max, b.max);
+                next[i].rms = std::sqrt((a.rms * a.rms + b.rms * b.rms) * 0.5f);
+            } else {
+                next[i] = a;
+            }
+        }
+        levels.push_back(std::move(next));
+    }
+}
+
+bool AudioPeaks::LoadCache(const std::filesystem::path& cachePath) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file) return false;
+
+    uint32_t magic = 0, version = 0;
+    uint64_t cachedSize = 0;
+    int64_t cachedTime = 0;
+    int32_t cachedRate = 0;
+    int64_t cachedSamples = 0;
+    uint64_t baseCount = 0;
+    uint32_t pathLength = 0;
+    file.read((char*)&magic, sizeof(magic));
+    file.read((char*)&version, sizeof(version));
+    file.read((char*)&pathLength, sizeof(pathLength));
+    if (!file || magic != kCacheMagic || version != kCacheVersion || pathLength != sourcePath.size()) {
+        return false;
+    }
+    std::string cachedPath(pathLength, '\0');
+    file.read(&cachedPath[0], pathLength);
+    file.read((char*)&cachedSize, sizeof(cachedSize));
+    file.read((char*)&cachedTime, sizeof(cachedTime));
+    file.read((char*)&cachedRate, sizeof(cachedRate));
+    file.read((char*)&cachedSamples, sizeof(cachedSamples));
+    file.read((char*)&baseCount, sizeof(baseCount));
+    if (!file || cachedPath != sourcePath ||
+        cachedSize != sourceSize || cachedTime != sourceTime || cachedRate <= 0 ||
+        baseCount != (uint64_t)((cachedSamples + kBaseBucketSamples - 1) / kBaseBucketSamples)) {
+        return false;
+    }
+
+    // 只缓存第 0 层，其余层加载时重新归并，代价很小
+    std::vector<PeakBucket> baseLevel((size_t)baseCount);
+    file.read((char*)baseLevel.data(), baseLevel.size() * sizeof(PeakBucket));
+    if (!file) return false;
+
+    sampleRate = cachedRate;
+    totalSamples = cachedSamples;
+    BuildLevels(std::move(baseLevel));
+
+    // 刷新修改时间，目录淘汰时据此判断最近使用
+    std::error_code error;
+    std::filesystem::last_write_time(cachePath, std::filesystem::file_time_type::clock::now(), error);
+    return true;
+}
+
+void AudioPeaks::SaveCache(const std::filesystem::path& cachePath) const {
+    if (levels.empty()) return;
+
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    if (!file) return;
+
+    const std::vector<PeakBucket>& baseLevel = levels.front();
+    int32_t rate = sampleRate;
+    uint64_t baseCount = baseLevel.size();
+    uint32_t pathLength = (uint32_t)sourcePath.size();
+    file.write((const char*)&kCacheMagic, sizeof(kCacheMagic));
+    file.write((const char*)&kCacheVersion, sizeof(kCacheVersion));
+    file.write((const char*)&pathLength, sizeof(pathLength));
+    file.write(sourcePath.data(), pathLength);
+    file.write((const char*)&sourceSize, sizeof(sourceSize));
+    file.write((const char*)&sourceTime, sizeof(sourceTime));
+    file.write((const char*)&rate, sizeof(rate));
+    file.write((const char*)&totalSamples, sizeof(totalSamples));
+    file.write((const char*)&baseCount, sizeof(baseCount));
+    file.write((const char*)baseLevel.data(), baseLevel.size() * sizeof(PeakBucket));
+}
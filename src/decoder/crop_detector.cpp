@@ -0,0 +1,169 @@
+#include "decoder/crop_detector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CROP_USE_SSE2 1
+#endif
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+}
+
+// 有限范围的黑电平为 16，留出噪声余量
+static const uint8_t kBlackThreshold = 32;
+// 内容区域内每隔若干行取样检测左右边界
+static const int kColumnSampleStep = 8;
+
+// 返回一行中第一个亮于阈值的像素下标，全黑时返回 width
+static int FindFirstBright(const uint8_t* row, int width) {
+    int x = 0;
+#ifdef CROP_USE_SSE2
+    const __m128i threshold = _mm_set1_epi8((char)kBlackThreshold);
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 16 <= width; x += 16) {
+        __m128i bright = _mm_subs_epu8(_mm_loadu_si128((const __m128i*)(row + x)), threshold);
+        int darkMask = _mm_movemask_epi8(_mm_cmpeq_epi8(bright, zero));
+        if (darkMask != 0xFFFF) {
+            for (int i = 0; i < 16; i++) {
+                if (!(darkMask & (1 << i))) return x + i;
+            }
+        }
+    }
+#endif
+    for (; x < width; x++) {
+        if (row[x] > kBlackThreshold) return x;
+    }
+    return width;
+}
+
+// 返回一行中最后一个亮于阈值的像素下标，全黑时返回 -1
+static int FindLastBright(const uint8_t* row, int width) {
+    int x = width;
+#ifdef CROP_USE_SSE2
+    const __m128i threshold = _mm_set1_epi8((char)kBlackThreshold);
+    const __m128i zero = _mm_setzero_si128();
+    for (; x - 16 >= 0; x -= 16) {
+        __m128i bright = _mm_subs_epu8(_mm_loadu_si128((const __m128i*)(row + x - 16)), threshold);
+        int darkMask = _mm_movemask_epi8(_mm_cmpeq_epi8(bright, zero));
+        if (darkMask != 0xFFFF) {
+            for (int i = 15; i >= 0; i--) {
+                if (!(darkMask & (1 << i))) return x - 16 + i;
+            }
+        }
+    }
+#endif
+    for (x--; x >= 0; x--) {
+        if (row[x] > kBlackThreshold) return x;
+    }
+    return -1;
+}
+
+void CropDetector::Reset() {
+    frameWidth = 0;
+    frameHeight = 0;
+    alignX = 1;
+    alignY = 1;
+    left = top = right = bottom = 0;
+    sampledFrames = 0;
+    detectMicros = 0;
+}
+
+bool CropDetector::Feed(const AVFrame* frame) {
+    if (!frame || !frame->data[0] || frame->width <= 0 || frame->height <= 0) return false;
+
+    // 分辨率变化时重新开始；先记录尺寸，不支持的格式也能得到整帧
+    if (frame->width != frameWidth || frame->height != frameHeight) {
+        Reset();
+        frameWidth = frame->width;
+        frameHeight = frame->height;
+    }
+
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get((AVPixelFormat)frame->format);
+    if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_PAL |
+                                 AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_BITSTREAM)) ||
+        desc->comp[0].depth != 8 || desc->comp[0].step != 1 || desc->comp[0].plane != 0) {
+        return false;
+    }
+    alignX = 1 << desc->log2_chroma_w;
+    alignY = 1 << desc->log2_chroma_h;
+
+    auto start = std::chrono::steady_clock::now();
+
+    const uint8_t* luma = frame->data[0];
+    int linesize = frame->linesize[0];
+    int width = frame->width;
+    int height = frame->height;
+
+    // 上下黑边：从两端逐行向内，遇到含亮像素的行即停止
+    int contentTop = 0;
+    while (contentTop < height && FindFirstBright(luma + (ptrdiff_t)contentTop * linesize, width) == width) {
+        contentTop++;
+    }
+
+    bool accepted = contentTop < height;
+    if (accepted) {
+        int contentBottom = height - 1;
+        while (contentBottom > contentTop &&
+               FindFirstBright(luma + (ptrdiff_t)contentBottom * linesize, width) == width) {
+            contentBottom--;
+        }
+
+        // 左右黑边：在内容行中取样
+        int contentLeft = width;
+        int contentRight = -1;
+        for (int y = contentTop; y <= contentBottom; y += kColumnSampleStep) {
+            const uint8_t* row = luma + (ptrdiff_t)y * linesize;
+            contentLeft = std::min(contentLeft, FindFirstBright(row, contentLeft));
+            if (contentRight < width - 1) {
+                int last = FindLastBright(row + contentRight + 1, width - contentRight - 1);
+                if (last >= 0) contentRight += last + 1;
+            }
+        }
+        if (contentRight < contentLeft) {
+            contentLeft = 0;
+            contentRight = width - 1;
+        }
+
+        if (sampledFrames == 0) {
+            left = contentLeft;
+            top = contentTop;
+            right = contentRight + 1;
+            bottom = contentBottom + 1;
+        } else {
+            left = std::min(left, contentLeft);
+            top = std::min(top, contentTop);
+            right = std::max(right, contentRight + 1);
+            bottom = std::max(bottom, contentBottom + 1);
+        }
+        sampledFrames++;
+    }
+
+    detectMicros += std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return accepted;
+}
+
+CropRect CropDetector::GetCrop() const {
+    CropRect crop;
+    if (sampledFrames == 0) {
+        crop.width = frameWidth;
+        crop.height = frameHeight;
+        return crop;
+    }
+
+    // 向外对齐到色度子采样，保证各平面的起点一致且不裁掉内容
+    int x0 = left & ~(alignX - 1);
+    int y0 = top & ~(alignY - 1);
+    int x1 = std::min((right + alignX - 1) & ~(alignX - 1), frameWidth);
+    int y1 = std::min((bottom + alignY - 1) & ~(alignY - 1), frameHeight);
+
+    crop.x = x0;
+    crop.y = y0;
+    crop.width = x1 - x0;
+    crop.height = y1 - y0;
+    return crop;
+}
@@ -1,11 +1,33 @@
 #include "decoder/ffmpeg_decoder.hpp"
-#include <Windows.h>
+#include "utils/perf_counters.hpp"
+#include "utils/utf8.hpp"
+#include <chrono>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/avutil.h>
-#include <libswscale/swscale.h>
+}
+
+// 检测黑边时额外取样的帧数
+static const int kCropProbeFrames = 4;
+
+// 包装默认的帧缓冲分配，统计解码器取用的缓冲数量与大小
+static int CountingGetBuffer(AVCodecContext* context, AVFrame* frame, int flags) {
+    int ret = avcodec_default_get_buffer2(context, frame, flags);
+    if (ret >= 0) {
+        uint64_t bytes = 0;
+        for (int i = 0; i < AV_NUM_DATA_POINTERS && frame->buf[i]; i++) {
+            bytes += frame->buf[i]->size;
+        }
+        PerfCounters& counters = GetPerfCounters();
+        counters.frameBuffers.fetch_add(1, std::memory_order_relaxed);
+        counters.frameBufferBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+FFmpegDecoder::FFmpegDecoder(ThreadPool* pool) : converter(pool) {
 }
 
 FFmpegDecoder::~FFmpegDecoder() {
@@ -14,10 +36,9 @@ FFmpegDecoder::~FFmpegDecoder() {
 
 bool FFmpegDecoder::OpenFile(const std::wstring& filename) {
     // 转换文件名为 UTF-8
-    char utf8_filename[260];
-    WideCharToMultiByte(CP_UTF8, 0, filename.c_str(), -1, utf8_filename, sizeof(utf8_filename), NULL, NULL);
+    std::string utf8Filename = ToUtf8(filename);
     
-    if (avformat_open_input(&formatContext, utf8_filename, NULL, NULL) < 0) {
+    if (avformat_open_input(&formatContext, utf8Filename.c_str(), NULL, NULL) < 0) {
         return false;
     }
     
@@ -44,12 +65,16 @@ bool FFmpegDecoder::OpenFile(const std::wstring& filename) {
     const AVCodec* codec = avcodec_find_decoder(formatContext->streams[videoStreamIndex]->codecpar->codec_id);
     codecContext = avcodec_alloc_context3(codec);
     avcodec_parameters_to_context(codecContext, formatContext->streams[videoStreamIndex]->codecpar);
+    codecContext->get_buffer2 = CountingGetBuffer;
     
     if (avcodec_open2(codecContext, codec, NULL) < 0) {
         Cleanup();
         return false;
     }
 
+    // 字幕流可选，打开失败时忽略
+    OpenSubtitleStream();
+
     // 分配 packet 和 frame
     packet = av_packet_alloc();
     frame = av_frame_alloc();
@@ -57,40 +82,181 @@ bool FFmpegDecoder::OpenFile(const std::wstring& filename) {
     return true;
 }
 
-bool FFmpegDecoder::DecodeFirstFrame(uint8_t** frameData, int* width, int* height) {
-    bool frameDecoded = false;
-    
-    while (av_read_frame(formatContext, packet) >= 0 && !frameDecoded) {
-        if (packet->stream_index == videoStreamIndex) {
-            avcodec_send_packet(codecContext, packet);
-            if (avcodec_receive_frame(codecContext, frame) == 0) {
-                // 转换为 BGR 格式
-                SwsContext* swsContext = sws_getContext(
-                    frame->width, frame->height, (AVPixelFormat)frame->format,
-                    frame->width, frame->height, AV_PIX_FMT_BGR24,
-                    SWS_BILINEAR, NULL, NULL, NULL);
-                
-                *width = frame->width;
-                *height = frame->height;
-                *frameData = (uint8_t*)malloc(frame->width * frame->height * 3);
-                
-                uint8_t* dest[4] = { *frameData, NULL, NULL, NULL };
-                int destLinesize[4] = { frame->width * 3, 0, 0, 0 };
-                
-                sws_scale(swsContext, frame->data, frame->linesize, 0,
-                         frame->height, dest, destLinesize);
-                
-                sws_freeContext(swsContext);
-                frameDecoded = true;
+void FFmpegDecoder::OpenSubtitleStream() {
+    const AVCodec* codec = nullptr;
+    int streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_SUBTITLE, -1, videoStreamIndex, &codec, 0);
+    if (streamIndex < 0 || !codec) {
+        return;
+    }
+
+    AVStream* stream = formatContext->streams[streamIndex];
+    subtitleCodecContext = avcodec_alloc_context3(codec);
+    avcodec_parameters_to_context(subtitleCodecContext, stream->codecpar);
+    subtitleCodecContext->pkt_timebase = stream->time_base;
+
+    if (avcodec_open2(subtitleCodecContext, codec, NULL) < 0) {
+        avcodec_free_context(&subtitleCodecContext);
+        return;
+    }
+    subtitleStreamIndex = streamIndex;
+}
+
+void FFmpegDecoder::DecodeSubtitlePacket() {
+    AVSubtitle subtitle;
+    int gotSubtitle = 0;
+    if (avcodec_decode_subtitle2(subtitleCodecContext, &subtitle, &gotSubtitle, packet) < 0 || !gotSubtitle) {
+        return;
+    }
+
+    AVStream* stream = formatContext->streams[subtitleStreamIndex];
+    double time = 0.0;
+    if (subtitle.pts != AV_NOPTS_VALUE) {
+        time = subtitle.pts / (double)AV_TIME_BASE;
+    } else if (packet->pts != AV_NOPTS_VALUE) {
+        time = packet->pts * av_q2d(stream->time_base);
+    }
+    double duration = packet->duration > 0 ? packet->duration * av_q2d(stream->time_base) : 0.0;
+
+    subtitles.AddSubtitle(subtitle, time, duration, subtitleCodecContext->width, subtitleCodecContext->height);
+    avsubtitle_free(&subtitle);
+}
+
+void FFmpegDecoder::FlushDecoders() {
+    // 定位后丢弃未送入的数据包，并退出冲刷模式
+    if (packetPending) {
+        av_packet_unref(packet);
+        packetPending = false;
+    }
+    draining = false;
+    avcodec_flush_buffers(codecContext);
+    if (subtitleCodecContext) {
+        avcodec_flush_buffers(subtitleCodecContext);
+    }
+}
+
+double FFmpegDecoder::GetFrameTime() const {
+    if (!frame || frame->best_effort_timestamp == AV_NOPTS_VALUE) return 0.0;
+    return frame->best_effort_timestamp * av_q2d(formatContext->streams[videoStreamIndex]->time_base);
+}
+
+int FFmpegDecoder::GetFrameWidth() const {
+    return frame ? frame->width : 0;
+}
+
+int FFmpegDecoder::GetFrameHeight() const {
+    return frame ? frame->height : 0;
+}
+
+bool FFmpegDecoder::DecodeNextFrame(AVFrame* target) {
+    for (;;) {
+        // 先取解码器中已缓冲的帧：一个数据包可能产生多帧，B 帧流还会延迟输出
+        int ret = avcodec_receive_frame(codecContext, target);
+        if (ret == 0) return true;
+        if (ret == AVERROR_EOF) return false;  // 冲刷完毕
+        if (ret != AVERROR(EAGAIN)) continue;  // 损坏的帧，跳过
+
+        if (!packetPending) {
+            if (av_read_frame(formatContext, packet) < 0) {
+                // 文件结束：送入空包进入冲刷模式，取出解码器中剩余的帧
+                if (draining) return false;
+                draining = true;
+                if (avcodec_send_packet(codecContext, NULL) < 0) return false;
+                continue;
+            }
+            if (packet->stream_index != videoStreamIndex) {
+                if (packet->stream_index == subtitleStreamIndex) {
+                    DecodeSubtitlePacket();
+                }
+                av_packet_unref(packet);
+                continue;
             }
         }
+
+        // 解码器输出队列已满时保留数据包，取出帧后重发；连续两次 EAGAIN 说明解码器异常，丢弃该包
+        ret = avcodec_send_packet(codecContext, packet);
+        if (ret == AVERROR(EAGAIN) && !packetPending) {
+            packetPending = true;
+            continue;
+        }
+        packetPending = false;
         av_packet_unref(packet);
     }
-    
-    return frameDecoded;
+}
+
+bool FFmpegDecoder::DecodeFirstFrame(int* width, int* height) {
+    if (!DecodeNextFrame(frame)) {
+        return false;
+    }
+
+    DetectCrop();
+    converter.SetCrop(crop);
+
+    *width = crop.width;
+    *height = crop.height;
+    return true;
+}
+
+bool FFmpegDecoder::DecodeFrame() {
+    if (!formatContext || !frame) return false;
+    return DecodeNextFrame(frame);
+}
+
+void FFmpegDecoder::DetectCrop() {
+    // 取样需要多次定位与解码，在窗口出现前同步执行，计入检测耗时
+    auto start = std::chrono::steady_clock::now();
+    cropDetector.Reset();
+    cropDetector.Feed(frame);
+
+    // 在全片均匀取几个时间点采样，避免片头黑场或暗场景误判
+    bool seekable = formatContext->pb && (formatContext->pb->seekable & AVIO_SEEKABLE_NORMAL);
+    if (seekable && formatContext->duration > 0) {
+        int64_t startTime = formatContext->start_time != AV_NOPTS_VALUE ? formatContext->start_time : 0;
+        AVFrame* probeFrame = av_frame_alloc();
+        for (int i = 1; i <= kCropProbeFrames; i++) {
+            int64_t target = startTime + formatContext->duration * i / (kCropProbeFrames + 1);
+            if (av_seek_frame(formatContext, -1, target, AVSEEK_FLAG_BACKWARD) < 0) break;
+            FlushDecoders();
+            if (DecodeNextFrame(probeFrame)) {
+                cropDetector.Feed(probeFrame);
+            }
+            av_frame_unref(probeFrame);
+        }
+
+        // 回到开头并重新解出第一帧，使解码位置与取样前一致；失败时保留原来的帧
+        av_seek_frame(formatContext, -1, startTime, AVSEEK_FLAG_BACKWARD);
+        FlushDecoders();
+        if (DecodeNextFrame(probeFrame)) {
+            av_frame_unref(frame);
+            av_frame_move_ref(frame, probeFrame);
+        }
+        av_frame_free(&probeFrame);
+    }
+
+    // 检测器拒绝或尚未得到区域时输出整帧，保证尺寸有效
+    crop = cropDetector.GetCrop();
+    if (crop.width <= 0 || crop.height <= 0) {
+        crop.x = 0;
+        crop.y = 0;
+        crop.width = frame->width;
+        crop.height = frame->height;
+    }
+
+    PerfCounters& counters = GetPerfCounters();
+    counters.cropSavedBytes.store(
+        ((uint64_t)frame->width * frame->height - (uint64_t)crop.width * crop.height) * 4,
+        std::memory_order_relaxed);
+    counters.cropScanMicros.store(cropDetector.GetDetectMicros(), std::memory_order_relaxed);
+    counters.cropDetectMicros.store(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+}
+
+bool FFmpegDecoder::ConvertFrame(uint8_t* dest, int destPitch, int destWidth, int destHeight) {
+    // 直接转换为 BGRA，与纹理格式一致；大分辨率下按条带并行
+    return converter.Convert(frame, dest, destPitch, destWidth, destHeight);
 }
 
 void FFmpegDecoder::Cleanup() {
+    converter.Cleanup();
     if (frame) {
         av_frame_free(&frame);
         frame = nullptr;
@@ -103,9 +269,18 @@ void FFmpegDecoder::Cleanup() {
         avcodec_free_context(&codecContext);
         codecContext = nullptr;
     }
+    if (subtitleCodecContext) {
+        avcodec_free_context(&subtitleCodecContext);
+        subtitleCodecContext = nullptr;
+    }
+    subtitleStreamIndex = -1;
+    subtitles.Clear();
+    crop = CropRect();
     if (formatContext) {
         avformat_close_input(&formatContext);
         formatContext = nullptr;
     }
     videoStreamIndex = -1;
+    packetPending = false;
+    draining = false;
 }
@@ -0,0 +1,239 @@
+#include "decoder/frame_converter.hpp"
+#include "utils/perf_counters.hpp"
+#include "utils/thread_pool.hpp"
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+// 单个条带的最小行数，过小时线程调度开销会超过转换本身
+static const int kMinBandRows = 64;
+
+// 不缩放时，只有以下情况条带转换与整帧转换逐字节一致：
+// 8 位 4:2:0/4:2:2 且高度为偶数，整帧与各条带都走 swscale 的 yuv2rgb 专用路径
+// （奇数高度会退回通用路径，舍入不同）；8 位 4:4:4 各行独立。
+// 其余格式走通用路径，其最后两行改用 C 实现，舍入与 SIMD 行不同，条带边界会有接缝
+static bool CanSplitBands(AVPixelFormat format, int height) {
+    if (format == AV_PIX_FMT_YUV444P) return true;
+    return (format == AV_PIX_FMT_YUV420P || format == AV_PIX_FMT_YUVJ420P ||
+            format == AV_PIX_FMT_YUV422P) && (height % 2) == 0;
+}
+
+// 条带起始行对齐到 2：满足 4:2:0 色度行对齐，并保证各条带高度为偶数
+static const int kBandAlign = 2;
+
+// 计算裁剪区域内第 y 行、第 x 列处各平面的起始指针；调色板平面保持原样
+static void OffsetPlanes(const AVFrame* frame, const AVPixFmtDescriptor* desc, int x, int y, uint8_t* out[4]) {
+    ptrdiff_t columnOffset[4] = {};
+    for (int c = 0; c < desc->nb_components; c++) {
+        int p = desc->comp[c].plane;
+        int columnShift = (p == 1 || p == 2) ? desc->log2_chroma_w : 0;
+        columnOffset[p] = (ptrdiff_t)(x >> columnShift) * desc->comp[c].step;
+    }
+
+    bool hasPalette = (desc->flags & AV_PIX_FMT_FLAG_PAL) != 0;
+    for (int p = 0; p < 4; p++) {
+        out[p] = frame->data[p];
+        if (!out[p] || (hasPalette && p == 1)) continue;
+        int rowShift = (p == 1 || p == 2) ? desc->log2_chroma_h : 0;
+        out[p] += (ptrdiff_t)(y >> rowShift) * frame->linesize[p] + columnOffset[p];
+    }
+}
+
+// 借用的缓冲由解码帧或调用方持有，包装成 AVBufferRef 时不需要释放
+static void KeepBuffer(void*, uint8_t*) {
+}
+
+// 描述一帧借用的内存：只填写指针与尺寸，buf[0] 指向常驻的借用引用，不分配
+static void SetBorrowedView(AVFrame* view, AVBufferRef* borrowed, int format, int width, int height) {
+    view->format = format;
+    view->width = width;
+    view->height = height;
+    view->buf[0] = borrowed;
+}
+
+FrameConverter::FrameConverter(ThreadPool* pool) : threadPool(pool) {
+}
+
+FrameConverter::~FrameConverter() {
+    Cleanup();
+    av_frame_free(&sourceView);
+    av_frame_free(&targetView);
+    av_buffer_unref(&borrowedBuffer);
+}
+
+void FrameConverter::Cleanup() {
+    for (auto& band : bands) {
+        if (band.swsContext) {
+            sws_freeContext(band.swsContext);
+        }
+    }
+    bands.clear();
+    swscaleThreads = false;
+    bandWidth = 0;
+    bandSourceHeight = 0;
+    bandFormat = -1;
+}
+
+bool FrameConverter::Prepare(int width, int height, int format) {
+    if (width == bandWidth && height == bandSourceHeight && format == bandFormat && !bands.empty()) {
+        return true;
+    }
+    Cleanup();
+
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get((AVPixelFormat)format);
+    if (!desc) return false;
+
+    int threadCount = threadPool ? (int)threadPool->GetThreadCount() : 1;
+
+    if (threadCount > 1 && !CanSplitBands((AVPixelFormat)format, height)) {
+        // 整帧一个上下文，由 swscale 内部按切片并行，保证与单线程输出一致。
+        // 线程数与线程池相同：转换期间调用方阻塞、池内线程空闲，同时运行的线程不超过池的规模
+        Band band;
+        band.height = height;
+        band.swsContext = sws_alloc_context();
+        if (!band.swsContext) return false;
+        av_opt_set_int(band.swsContext, "srcw", width, 0);
+        av_opt_set_int(band.swsContext, "srch", height, 0);
+        av_opt_set_int(band.swsContext, "src_format", format, 0);
+        av_opt_set_int(band.swsContext, "dstw", width, 0);
+        av_opt_set_int(band.swsContext, "dsth", height, 0);
+        av_opt_set_int(band.swsContext, "dst_format", AV_PIX_FMT_BGRA, 0);
+        av_opt_set_int(band.swsContext, "sws_flags", SWS_BILINEAR, 0);
+        av_opt_set_int(band.swsContext, "threads", threadCount, 0);
+        if (sws_init_context(band.swsContext, NULL, NULL) < 0) {
+            sws_freeContext(band.swsContext);
+            return false;
+        }
+        if (!sourceView) sourceView = av_frame_alloc();
+        if (!targetView) targetView = av_frame_alloc();
+        if (!borrowedBuffer) {
+            static uint8_t placeholder;
+            borrowedBuffer = av_buffer_create(&placeholder, 0, KeepBuffer, NULL, 0);
+        }
+        if (!sourceView || !targetView || !borrowedBuffer) {
+            sws_freeContext(band.swsContext);
+            return false;
+        }
+        bands.push_back(band);
+        swscaleThreads = true;
+    } else {
+        int bandCount = threadCount;
+        if (bandCount > height / kMinBandRows) bandCount = height / kMinBandRows;
+        if (bandCount < 1) bandCount = 1;
+
+        for (int i = 0; i < bandCount; i++) {
+            int y0 = (int)((int64_t)height * i / bandCount) & ~(kBandAlign - 1);
+            int y1 = (i == bandCount - 1) ? height : ((int)((int64_t)height * (i + 1) / bandCount) & ~(kBandAlign - 1));
+            if (y1 <= y0) continue;
+
+            Band band;
+            band.y = y0;
+            band.height = y1 - y0;
+            band.swsContext = sws_getContext(
+                width, band.height, (AVPixelFormat)format,
+                width, band.height, AV_PIX_FMT_BGRA,
+                SWS_BILINEAR, NULL, NULL, NULL);
+            if (!band.swsContext) {
+                Cleanup();
+                return false;
+            }
+            bands.push_back(band);
+        }
+    }
+
+    bandWidth = width;
+    bandSourceHeight = height;
+    bandFormat = format;
+    return true;
+}
+
+bool FrameConverter::ConvertWithSwscaleThreads(const AVFrame* frame, const CropRect& region,
+                                               uint8_t* dest, int destPitch) {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get((AVPixelFormat)frame->format);
+
+    // sws_scale_frame 要求帧带有缓冲引用，但转换是同步的，解码帧与目标内存在此期间一直有效。
+    // 两个视图只借用指针，共用一个常驻的借用引用，不再为每帧引用解码帧或包装目标内存
+    // （swscale 内部仍会为两帧各增加一次引用）
+    SetBorrowedView(sourceView, borrowedBuffer, frame->format, region.width, region.height);
+    OffsetPlanes(frame, desc, region.x, region.y, sourceView->data);
+    for (int p = 0; p < AV_NUM_DATA_POINTERS; p++) {
+        sourceView->linesize[p] = frame->linesize[p];
+    }
+    sourceView->color_range = frame->color_range;
+    sourceView->colorspace = frame->colorspace;
+
+    SetBorrowedView(targetView, borrowedBuffer, AV_PIX_FMT_BGRA, region.width, region.height);
+    targetView->data[0] = dest;
+    targetView->linesize[0] = destPitch;
+
+    bool ok = sws_scale_frame(bands[0].swsContext, targetView, sourceView) >= 0;
+    // 视图只是借用，不能 av_frame_unref：清空指针即可
+    sourceView->buf[0] = NULL;
+    targetView->buf[0] = NULL;
+    return ok;
+}
+
+bool FrameConverter::Convert(const AVFrame* frame, uint8_t* dest, int destPitch, int destWidth, int destHeight) {
+    if (!frame || !frame->data[0] || !dest) return false;
+
+    // 未设置裁剪时转换整帧；裁剪区域超出当前帧（如分辨率变化）时拒绝转换，
+    // 不能退回整帧：目标按裁剪尺寸分配，更大的区域会写越界
+    CropRect region = crop;
+    if (region.width <= 0 || region.height <= 0) {
+        region.x = 0;
+        region.y = 0;
+        region.width = frame->width;
+        region.height = frame->height;
+    } else if (region.x < 0 || region.y < 0 ||
+               region.x + region.width > frame->width || region.y + region.height > frame->height) {
+        return false;
+    }
+    // 目标尺寸必须与输出区域一致
+    if (region.width != destWidth || region.height != destHeight || destPitch < destWidth * 4) {
+        return false;
+    }
+    if (!Prepare(region.width, region.height, frame->format)) return false;
+
+    if (swscaleThreads) {
+        if (!ConvertWithSwscaleThreads(frame, region, dest, destPitch)) return false;
+    } else {
+        // 各条带共享的参数；lambda 只捕获这一个引用，std::function 不需要堆分配
+        struct BandJob {
+            FrameConverter* converter;
+            const AVFrame* frame;
+            const AVPixFmtDescriptor* desc;
+            CropRect region;
+            uint8_t* dest;
+            int destPitch;
+        } job = { this, frame, av_pix_fmt_desc_get((AVPixelFormat)frame->format), region, dest, destPitch };
+
+        auto convertBand = [&job](int index) {
+            const Band& band = job.converter->bands[index];
+
+            uint8_t* srcData[4];
+            OffsetPlanes(job.frame, job.desc, job.region.x, job.region.y + band.y, srcData);
+
+            uint8_t* destData[4] = { job.dest + (ptrdiff_t)band.y * job.destPitch, NULL, NULL, NULL };
+            int destLinesize[4] = { job.destPitch, 0, 0, 0 };
+
+            sws_scale(band.swsContext, srcData, job.frame->linesize, 0,
+                     band.height, destData, destLinesize);
+        };
+
+        if (threadPool && bands.size() > 1) {
+            threadPool->ParallelFor((int)bands.size(), convertBand);
+        } else {
+            for (int i = 0; i < (int)bands.size(); i++) {
+                convertBand(i);
+            }
+        }
+    }
+
+    GetPerfCounters().convertedBytes.fetch_add(
+        (uint64_t)region.width * 4 * region.height, std::memory_order_relaxed);
+    return true;
+}
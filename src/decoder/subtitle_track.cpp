@@ -0,0 +1,156 @@
+#include "decoder/subtitle_track.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+// 重复加入（如寻址后再次解出同一包）时，起始时间差小于此值视为同一事件
+static const double kDuplicateTolerance = 0.001;
+
+// ASS 事件格式为 "ReadOrder,Layer,Style,Name,MarginL,MarginR,MarginV,Effect,Text"，
+// 取出 Text 字段并去掉 {...} 样式标签
+static std::string ExtractAssText(const char* ass) {
+    const char* text = ass;
+    for (int commas = 0; commas < 8 && *text; text++) {
+        if (*text == ',') commas++;
+    }
+    std::string result;
+    bool inTag = false;
+    for (const char* p = text; *p; p++) {
+        if (inTag) {
+            if (*p == '}') inTag = false;
+            continue;
+        }
+        if (*p == '{') {
+            inTag = true;
+        } else if (*p == '\\' && (p[1] == 'N' || p[1] == 'n')) {
+            result += '\n';
+            p++;
+        } else if (*p == '\\' && p[1] == 'h') {
+            result += ' ';
+            p++;
+        } else if (*p != '\r' && !(*p == '\n' && p[1] == '\0')) {
+            result += *p;
+        }
+    }
+    return result;
+}
+
+// 调色板索引展开为 32 位像素，只在解码时做一次。
+// 超出图集的位图按最近邻等比缩小，显示尺寸保持不变，绘制时再拉伸回原大小
+static SubtitleBitmap ExpandBitmap(const AVSubtitleRect& rect) {
+    SubtitleBitmap bitmap;
+    bitmap.x = rect.x;
+    bitmap.y = rect.y;
+    bitmap.width = rect.w;
+    bitmap.height = rect.h;
+    bitmap.pixelWidth = rect.w;
+    bitmap.pixelHeight = rect.h;
+
+    const int maxSize = SubtitleTrack::kMaxBitmapSize;
+    if (rect.w > maxSize || rect.h > maxSize) {
+        double scale = std::min((double)maxSize / rect.w, (double)maxSize / rect.h);
+        bitmap.pixelWidth = std::max(1, std::min(maxSize, (int)(rect.w * scale)));
+        bitmap.pixelHeight = std::max(1, std::min(maxSize, (int)(rect.h * scale)));
+    }
+
+    bitmap.pixels.resize((size_t)bitmap.pixelWidth * bitmap.pixelHeight);
+    const uint32_t* palette = (const uint32_t*)rect.data[1];
+    for (int y = 0; y < bitmap.pixelHeight; y++) {
+        int srcY = (int)((int64_t)y * rect.h / bitmap.pixelHeight);
+        const uint8_t* src = rect.data[0] + (ptrdiff_t)srcY * rect.linesize[0];
+        uint32_t* dest = bitmap.pixels.data() + (size_t)y * bitmap.pixelWidth;
+        for (int x = 0; x < bitmap.pixelWidth; x++) {
+            uint8_t index = src[(int64_t)x * rect.w / bitmap.pixelWidth];
+            dest[x] = index < rect.nb_colors ? palette[index] : 0;
+        }
+    }
+    return bitmap;
+}
+
+void SubtitleTrack::AddSubtitle(const AVSubtitle& subtitle, double time, double packetDuration,
+                                int canvasWidth, int canvasHeight) {
+    double start = time + subtitle.start_display_time / 1000.0;
+
+    // 没有区域的字幕表示清屏，结束之前尚未确定结束时间的事件
+    if (subtitle.num_rects == 0) {
+        earliestOpenStart = std::numeric_limits<double>::infinity();
+        for (auto& event : events) {
+            if (!std::isinf(event.end)) continue;
+            if (event.start < start) {
+                event.end = start;
+                longestDuration = std::max(longestDuration, event.end - event.start);
+            } else {
+                earliestOpenStart = std::min(earliestOpenStart, event.start);
+            }
+        }
+        return;
+    }
+
+    SubtitleEvent event;
+    event.start = start;
+    if (subtitle.end_display_time > subtitle.start_display_time && subtitle.end_display_time != UINT32_MAX) {
+        event.end = time + subtitle.end_display_time / 1000.0;
+    } else if (packetDuration > 0.0) {
+        event.end = time + packetDuration;
+    } else {
+        event.end = std::numeric_limits<double>::infinity();
+    }
+    event.canvasWidth = canvasWidth;
+    event.canvasHeight = canvasHeight;
+
+    for (unsigned int i = 0; i < subtitle.num_rects; i++) {
+        const AVSubtitleRect* rect = subtitle.rects[i];
+        if (rect->type == SUBTITLE_BITMAP && rect->w > 0 && rect->h > 0 && rect->data[0] && rect->data[1]) {
+            event.bitmaps.push_back(ExpandBitmap(*rect));
+        } else if (rect->type == SUBTITLE_ASS && rect->ass) {
+            if (!event.text.empty()) event.text += '\n';
+            event.text += ExtractAssText(rect->ass);
+        } else if (rect->type == SUBTITLE_TEXT && rect->text) {
+            if (!event.text.empty()) event.text += '\n';
+            event.text += rect->text;
+        }
+    }
+    if (event.text.empty() && event.bitmaps.empty()) return;
+
+    // 按开始时间插入，跳过重复事件
+    auto position = std::lower_bound(events.begin(), events.end(), start - kDuplicateTolerance,
+        [](const SubtitleEvent& e, double t) { return e.start < t; });
+    for (auto it = position; it != events.end() && it->start <= start + kDuplicateTolerance; ++it) {
+        if (it->text == event.text && it->bitmaps.size() == event.bitmaps.size()) return;
+    }
+
+    event.id = nextId++;
+    if (std::isinf(event.end)) {
+        earliestOpenStart = std::min(earliestOpenStart, event.start);
+    } else {
+        longestDuration = std::max(longestDuration, event.end - event.start);
+    }
+    events.insert(position, std::move(event));
+}
+
+void SubtitleTrack::Clear() {
+    events.clear();
+    longestDuration = 0.0;
+    earliestOpenStart = std::numeric_limits<double>::infinity();
+}
+
+void SubtitleTrack::GetActiveEvents(double time, std::vector<const SubtitleEvent*>& out) const {
+    out.clear();
+
+    // 从第一个开始晚于 time 的事件向前扫描，回溯到不可能再有事件覆盖 time 为止
+    auto last = std::upper_bound(events.begin(), events.end(), time,
+        [](double t, const SubtitleEvent& e) { return t < e.start; });
+    for (auto it = last; it != events.begin();) {
+        --it;
+        if (time < it->end) {
+            out.push_back(&*it);
+        } else if (it->start < time - longestDuration && it->start < earliestOpenStart) {
+            break;
+        }
+    }
+    std::reverse(out.begin(), out.end());
+}
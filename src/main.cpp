@@ -14,13 +14,18 @@ extern "C" {
 #include <libavutil/avutil.h>
 #include <libswscale/swscale.h>
 }
+#include "audio/audio_peaks.hpp"
 #include "decoder/ffmpeg_decoder.hpp"
 #include "renderer/d3d11_renderer.hpp"
 #include "ui/player_ui.hpp"
+#include "utils/thread_pool.hpp"
 
 // 添加全局变量用于存储视频帧
 struct VideoState {
-    uint8_t* frameBuffer;
+    std::unique_ptr<ThreadPool> workers;  // 最先创建、最后销毁
+    std::unique_ptr<FFmpegDecoder> decoder;
+    bool frameDirty = false;  // 解码器中有尚未上传到纹理的新帧
+    std::unique_ptr<AudioPeaks> audioPeaks;
     int width;
     int height;
     std::unique_ptr<D3D11Renderer> renderer;
@@ -31,17 +36,25 @@ bool InitD3D11(HWND hwnd);
 
 // 解码第一帧的函数
 bool DecodeFirstFrame(const wchar_t* filename) {
-    FFmpegDecoder decoder;
-    if (!decoder.OpenFile(filename)) {
+    // 解码器需要保留到渲染时，帧数据由它直接转换进纹理
+    videoState.workers = std::make_unique<ThreadPool>();
+    videoState.decoder = std::make_unique<FFmpegDecoder>(videoState.workers.get());
+    if (!videoState.decoder->OpenFile(filename)) {
         return false;
     }
     
-    return decoder.DecodeFirstFrame(&videoState.frameBuffer, &videoState.width, &videoState.height);
+    videoState.frameDirty = videoState.decoder->DecodeFirstFrame(&videoState.width, &videoState.height);
+    return videoState.frameDirty;
 }
 
 bool InitImGui(HWND hwnd, D3D11Renderer* renderer) {
     videoState.ui = std::make_unique<PlayerUI>();
-    return videoState.ui->Initialize(hwnd, renderer);
+    if (!videoState.ui->Initialize(hwnd, renderer)) {
+        return false;
+    }
+    videoState.ui->SetAudioPeaks(videoState.audioPeaks.get());
+    videoState.ui->SetDecoder(videoState.decoder.get());
+    return true;
 }
 
 // 窗口过程函数声明
@@ -79,6 +92,10 @@ int WINAPI WinMain(
         return 1;
     }
 
+    // 后台生成音频峰值概览，完成后显示在时间轴上
+    videoState.audioPeaks = std::make_unique<AudioPeaks>();
+    videoState.audioPeaks->BuildAsync(ofn.lpstrFile);
+
     // 注册窗口类
     WNDCLASSEX wc = {};
     wc.cbSize = sizeof(WNDCLASSEX);
@@ -133,8 +150,17 @@ int WINAPI WinMain(
         }
         
         // 直接渲染
-        if (videoState.frameBuffer && videoState.renderer) {
-            videoState.renderer->Render(videoState.frameBuffer);
+        if (videoState.decoder && videoState.renderer) {
+            D3D11Renderer::FrameWriter writeFrame;
+            if (videoState.frameDirty) {
+                writeFrame = [](uint8_t* dest, int pitch, int width, int height) {
+                    return videoState.decoder->ConvertFrame(dest, pitch, width, height);
+                };
+            }
+            // 上传成功后才清除标记，失败时下一轮重试
+            if (videoState.renderer->Render(writeFrame) && writeFrame) {
+                videoState.frameDirty = false;
+            }
             videoState.ui->Render();
             videoState.renderer->Present(1);
         }
@@ -157,8 +183,8 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 UINT height = HIWORD(lParam);
                 videoState.renderer->Resize(width, height);
             }
-            // if (videoState.frameBuffer && videoState.renderer) {
-            //     videoState.renderer->Render(videoState.frameBuffer);
+            // if (videoState.decoder && videoState.renderer) {
+            //     videoState.renderer->Render(nullptr);
             //     videoState.ui->Render();
             //     videoState.renderer->Present(1);
             // }
@@ -166,12 +192,11 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
         }
         
         case WM_DESTROY: {
-            if (videoState.frameBuffer) {
-                free(videoState.frameBuffer);
-                videoState.frameBuffer = nullptr;
-            }
             videoState.ui.reset();
             videoState.renderer.reset();
+            videoState.audioPeaks.reset();
+            videoState.decoder.reset();
+            videoState.workers.reset();
             PostQuitMessage(0);
             return 0;
         }
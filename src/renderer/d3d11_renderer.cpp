@@ -1,4 +1,5 @@
 #include "renderer/d3d11_renderer.hpp"
+#include "utils/perf_counters.hpp"
 #include <d3dcompiler.h>
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "d3dcompiler.lib")
@@ -64,28 +65,27 @@ bool D3D11Renderer::Initialize(HWND hwnd, int width, int height) {
     return true;
 }
 
-void D3D11Renderer::Render(const uint8_t* frameData) {
-    if (!frameData || !d3dContext || !videoTexture) return;
-
-    // 更新纹理数据
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
-    d3dContext->Map(videoTexture, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-    
-    // 复制帧数据到纹理，BGR -> BGRA 转换
-    uint8_t* dest = (uint8_t*)mappedResource.pData;
-    const uint8_t* src = frameData;
-    for (int y = 0; y < textureHeight; y++) {
-        uint8_t* destRow = dest + y * mappedResource.RowPitch;
-        const uint8_t* srcRow = src + y * textureWidth * 3;
-        for (int x = 0; x < textureWidth; x++) {
-            destRow[x * 4 + 0] = srcRow[x * 3 + 0]; // B
-            destRow[x * 4 + 1] = srcRow[x * 3 + 1]; // G
-            destRow[x * 4 + 2] = srcRow[x * 3 + 2]; // R
-            destRow[x * 4 + 3] = 255;               // A
+bool D3D11Renderer::Render(const FrameWriter& writeFrame) {
+    if (!d3dContext || !videoTexture) return false;
+
+    PerfCounters& counters = GetPerfCounters();
+    counters.renderedFrames.fetch_add(1, std::memory_order_relaxed);
+
+    // 更新纹理数据：由调用方直接写入映射内存，按 RowPitch 排布。
+    // WRITE_DISCARD 之后纹理内容未定义，写入失败时不再绘制该纹理
+    bool uploaded = true;
+    if (writeFrame) {
+        D3D11_MAPPED_SUBRESOURCE mappedResource;
+        uploaded = SUCCEEDED(d3dContext->Map(videoTexture, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource));
+        if (uploaded) {
+            uploaded = writeFrame((uint8_t*)mappedResource.pData, (int)mappedResource.RowPitch,
+                                  textureWidth, textureHeight);
+            counters.uploadedBytes.fetch_add(
+                (uint64_t)mappedResource.RowPitch * textureHeight, std::memory_order_relaxed);
+            d3dContext->Unmap(videoTexture, 0);
+            textureValid = uploaded;
         }
     }
-    
-    d3dContext->Unmap(videoTexture, 0);
 
     // 设置渲染目标和视口
     d3dContext->OMSetRenderTargets(1, &renderTargetView, nullptr);
@@ -122,6 +122,9 @@ void D3D11Renderer::Render(const uint8_t* frameData) {
     viewport.MinDepth = 0.0f;
     viewport.MaxDepth = 1.0f;
     d3dContext->RSSetViewports(1, &viewport);
+    videoViewport = viewport;
+
+    if (!textureValid) return uploaded;
     
     // 设置渲染状态
     d3dContext->IASetInputLayout(inputLayout);
@@ -139,6 +142,7 @@ void D3D11Renderer::Render(const uint8_t* frameData) {
     
     // 绘制
     d3dContext->DrawIndexed(6, 0, 0);
+    return uploaded;
 }
 
 void D3D11Renderer::Present(int syncInterval) {
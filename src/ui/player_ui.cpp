@@ -1,4 +1,13 @@
 #include "ui/player_ui.hpp"
+#include "audio/audio_peaks.hpp"
+#include "decoder/ffmpeg_decoder.hpp"
+#include <algorithm>
+
+// 字幕字体：系统自带的中文字体，不存在时使用 ImGui 默认字体
+static const char* kSubtitleFontPath = "C:\\Windows\\Fonts\\msyh.ttc";
+static const float kSubtitleFontSize = 32.0f;
+// 统计窗口的采样区间（帧）
+static const uint64_t kStatsIntervalFrames = 60;
 
 PlayerUI::~PlayerUI() {
     Shutdown();
@@ -11,10 +20,24 @@ bool PlayerUI::Initialize(HWND hwnd, D3D11Renderer* renderer) {
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;
 
+    // 字幕字形在字体图集中只光栅化一次，界面仍使用默认字体
+    io.Fonts->AddFontDefault();
+    ImFont* subtitleFont = nullptr;
+    if (GetFileAttributesA(kSubtitleFontPath) != INVALID_FILE_ATTRIBUTES) {
+        subtitleFont = io.Fonts->AddFontFromFileTTF(kSubtitleFontPath, kSubtitleFontSize, nullptr,
+                                                    io.Fonts->GetGlyphRangesChineseSimplifiedCommon());
+    }
+
     if (!ImGui_ImplWin32_Init(hwnd) || !ImGui_ImplDX11_Init(renderer->GetDevice(), renderer->GetContext())) {
         return false;
     }
 
+    if (!subtitleOverlay.Initialize(renderer->GetDevice(), renderer->GetContext())) {
+        return false;
+    }
+    subtitleOverlay.SetFont(subtitleFont ? subtitleFont : io.Fonts->Fonts[0]);
+    videoRenderer = renderer;
+
     initialized = true;
     return true;
 }
@@ -26,14 +49,138 @@ void PlayerUI::Render() {
     ImGui_ImplWin32_NewFrame();
     ImGui::NewFrame();
     
+    RenderSubtitles();
     ImGui::ShowDemoWindow(); // Show demo window! :)
+    RenderTimeline();
+    RenderStats();
     
     ImGui::Render();
     ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 }
 
+void PlayerUI::RenderSubtitles() {
+    if (!decoder || !videoRenderer) return;
+
+    decoder->GetSubtitles().GetActiveEvents(decoder->GetFrameTime(), activeSubtitles);
+    if (activeSubtitles.empty()) return;
+
+    // 画在背景层上，位于视频之上、界面窗口之下
+    subtitleOverlay.Render(ImGui::GetBackgroundDrawList(), activeSubtitles,
+                           videoRenderer->GetVideoViewport(), decoder->GetCrop(),
+                           decoder->GetFrameWidth(), decoder->GetFrameHeight());
+}
+
+void PlayerUI::RenderTimeline() {
+    if (!audioPeaks) return;
+
+    ImGui::Begin("Timeline");
+    if (!audioPeaks->IsReady()) {
+        ImGui::TextUnformatted("Building audio overview...");
+        ImGui::End();
+        return;
+    }
+
+    double duration = audioPeaks->GetDuration();
+    ImGui::SliderFloat("Zoom", &timelineZoom, 1.0f, 1024.0f, "%.0fx", ImGuiSliderFlags_Logarithmic);
+    float visibleDuration = (float)(duration / timelineZoom);
+    float maxOffset = std::max(0.0f, (float)duration - visibleDuration);
+    timelineOffset = std::min(timelineOffset, maxOffset);
+    ImGui::SliderFloat("Position", &timelineOffset, 0.0f, maxOffset, "%.1f s");
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImVec2 size(std::max(ImGui::GetContentRegionAvail().x, 1.0f), 80.0f);
+    ImGui::InvisibleButton("waveform", size);
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), IM_COL32(20, 20, 20, 255));
+
+    // 按当前缩放选取金字塔层级，每像素只需归并一到两个桶，与缩放倍数无关
+    double samplesPerPixel = visibleDuration * audioPeaks->GetSampleRate() / size.x;
+    int64_t bucketSamples = 0;
+    const std::vector<PeakBucket>* level = audioPeaks->GetLevel(samplesPerPixel, &bucketSamples);
+    if (level && !level->empty()) {
+        double firstSample = (double)timelineOffset * audioPeaks->GetSampleRate();
+        float centerY = origin.y + size.y * 0.5f;
+        float halfHeight = size.y * 0.5f;
+
+        for (int x = 0; x < (int)size.x; x++) {
+            int64_t begin = (int64_t)((firstSample + x * samplesPerPixel) / bucketSamples);
+            int64_t end = (int64_t)((firstSample + (x + 1) * samplesPerPixel) / bucketSamples);
+            if (begin >= (int64_t)level->size()) break;
+            end = std::min(std::max(end, begin + 1), (int64_t)level->size());
+
+            PeakBucket peak = (*level)[begin];
+            for (int64_t i = begin + 1; i < end; i++) {
+                const PeakBucket& bucket = (*level)[i];
+                peak.min = std::min(peak.min, bucket.min);
+                peak.max = std::max(peak.max, bucket.max);
+                peak.rms = std::max(peak.rms, bucket.rms);
+            }
+
+            float px = origin.x + x + 0.5f;
+            drawList->AddLine(ImVec2(px, centerY - peak.max * halfHeight),
+                              ImVec2(px, centerY - peak.min * halfHeight + 1.0f), IM_COL32(60, 120, 200, 255));
+            drawList->AddLine(ImVec2(px, centerY - peak.rms * halfHeight),
+                              ImVec2(px, centerY + peak.rms * halfHeight + 1.0f), IM_COL32(120, 180, 255, 255));
+        }
+    }
+
+    ImGui::End();
+}
+
+void PlayerUI::RenderStats() {
+    PerfSnapshot now = TakePerfSnapshot();
+    if (now.renderedFrames - statsBase.renderedFrames >= kStatsIntervalFrames) {
+        statsPrevious = statsBase;
+        statsCurrent = now;
+        statsBase = now;
+    }
+
+    ImGui::Begin("Stats");
+
+    uint64_t frames = statsCurrent.renderedFrames - statsPrevious.renderedFrames;
+    if (frames == 0) {
+        ImGui::TextUnformatted("Collecting...");
+        ImGui::End();
+        return;
+    }
+
+    double heapAllocations = (double)(statsCurrent.heapAllocations - statsPrevious.heapAllocations) / frames;
+    double heapBytes = (double)(statsCurrent.heapBytes - statsPrevious.heapBytes) / frames;
+    double frameBuffers = (double)(statsCurrent.frameBuffers - statsPrevious.frameBuffers) / frames;
+    double convertedBytes = (double)(statsCurrent.convertedBytes - statsPrevious.convertedBytes) / frames;
+    double uploadedBytes = (double)(statsCurrent.uploadedBytes - statsPrevious.uploadedBytes) / frames;
+
+    ImGui::Text("Per frame (avg over %llu frames)", (unsigned long long)frames);
+    ImVec4 allocationColor = heapAllocations > PerfCounters::kMaxHeapAllocationsPerFrame
+        ? ImVec4(1.0f, 0.3f, 0.3f, 1.0f) : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+    ImGui::TextColored(allocationColor, "Heap allocations: %.2f (%.0f bytes)", heapAllocations, heapBytes);
+    ImGui::Text("Decoder frame buffers: %.2f", frameBuffers);
+    ImGui::Text("Converted: %.0f bytes", convertedBytes);
+    ImGui::Text("Uploaded: %.0f bytes", uploadedBytes);
+
+    ImGui::Text("Saved by crop: %llu bytes (detect %llu us, scan %llu us)",
+                (unsigned long long)now.cropSavedBytes, (unsigned long long)now.cropDetectMicros,
+                (unsigned long long)now.cropScanMicros);
+
+    uint64_t subtitleHits = statsCurrent.subtitleCacheHits - statsPrevious.subtitleCacheHits;
+    uint64_t subtitleLookups = subtitleHits + statsCurrent.subtitleCacheMisses - statsPrevious.subtitleCacheMisses;
+    if (subtitleLookups > 0) {
+        ImGui::Text("Subtitle cache hit rate: %.1f%% (overlay %llu us)",
+                    100.0 * subtitleHits / subtitleLookups, (unsigned long long)now.subtitleOverlayMicros);
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Total heap allocations: %llu", (unsigned long long)now.heapAllocations);
+    ImGui::Text("Total decoder frame buffers: %llu (%llu bytes)",
+                (unsigned long long)now.frameBuffers, (unsigned long long)now.frameBufferBytes);
+
+    ImGui::End();
+}
+
 void PlayerUI::Shutdown() {
     if (initialized) {
+        subtitleOverlay.Shutdown();
         ImGui_ImplDX11_Shutdown();
         ImGui_ImplWin32_Shutdown();
         ImGui::DestroyContext();
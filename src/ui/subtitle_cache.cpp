@@ -0,0 +1,143 @@
+#include "ui/subtitle_cache.hpp"
+#include "utils/perf_counters.hpp"
+#include <algorithm>
+
+// 缓存条目超过此数量时清理长期未用的条目
+static const size_t kMaxCacheEntries = 256;
+static const uint64_t kCacheExpireFrames = 600;
+
+void SubtitleCache::Clear() {
+    cache.clear();
+    shelfX = 0;
+    shelfY = 0;
+    shelfHeight = 0;
+}
+
+void SubtitleCache::ResetAtlas() {
+    shelfX = 0;
+    shelfY = 0;
+    shelfHeight = 0;
+    atlasResets++;
+
+    // 图集内容失效，只保留不引用图集的条目
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (!it->second.bitmaps.empty()) {
+            it = cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool SubtitleCache::AllocateAtlas(int width, int height, int* x, int* y) {
+    if (width > kAtlasSize || height > kAtlasSize) return false;
+
+    if (shelfX + width > kAtlasSize) {
+        shelfY += shelfHeight;
+        shelfX = 0;
+        shelfHeight = 0;
+    }
+    if (shelfY + height > kAtlasSize) {
+        return false;
+    }
+
+    *x = shelfX;
+    *y = shelfY;
+    shelfX += width;
+    shelfHeight = std::max(shelfHeight, height);
+    return true;
+}
+
+bool SubtitleCache::CacheEvent(const SubtitleEvent& event, Entry& entry) {
+    // 位图：上传到图集，之后只引用 UV
+    for (const auto& bitmap : event.bitmaps) {
+        int x, y;
+        if (!AllocateAtlas(bitmap.pixelWidth, bitmap.pixelHeight, &x, &y)) {
+            return false;
+        }
+        if (upload) upload(bitmap, x, y);
+
+        CachedBitmap cached;
+        cached.u0 = (float)x / kAtlasSize;
+        cached.v0 = (float)y / kAtlasSize;
+        cached.u1 = (float)(x + bitmap.pixelWidth) / kAtlasSize;
+        cached.v1 = (float)(y + bitmap.pixelHeight) / kAtlasSize;
+        entry.bitmaps.push_back(cached);
+    }
+    return true;
+}
+
+void SubtitleCache::Prepare(const std::vector<const SubtitleEvent*>& events, std::vector<const Entry*>& entries) {
+    frameIndex++;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    entries.assign(events.size(), nullptr);
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        // 清空图集后重来时，本帧已取得的条目可能失效，计数也从头统计
+        hits = 0;
+        misses = 0;
+        bool atlasFull = false;
+
+        for (size_t i = 0; i < events.size(); i++) {
+            const SubtitleEvent& event = *events[i];
+            auto it = cache.find(event.id);
+            if (it != cache.end()) {
+                hits++;
+            } else {
+                misses++;
+                it = cache.emplace(event.id, Entry()).first;
+                Entry& entry = it->second;
+
+                if (!CacheEvent(event, entry)) {
+                    entry.bitmaps.clear();
+                    // 图集非空时清空一次再试；空图集也装不下（同一事件位图过多）则放弃位图
+                    if (attempt == 0 && !IsAtlasEmpty()) {
+                        cache.erase(it);
+                        atlasFull = true;
+                        break;
+                    }
+                    entry.bitmapsFailed = true;
+                }
+
+                // 文本：按行排版一次，保存字形四边形
+                if (!event.text.empty() && layout) {
+                    size_t begin = 0;
+                    while (begin <= event.text.size()) {
+                        size_t end = event.text.find('\n', begin);
+                        if (end == std::string::npos) end = event.text.size();
+
+                        CachedLine line;
+                        line.begin = begin;
+                        line.end = end;
+                        line.width = layout(event.text.c_str() + begin, event.text.c_str() + end, line.glyphs);
+                        entry.lines.push_back(std::move(line));
+                        begin = end + 1;
+                    }
+                }
+            }
+            it->second.lastUsedFrame = frameIndex;
+            entries[i] = &it->second;
+        }
+
+        if (!atlasFull) break;
+        ResetAtlas();
+        std::fill(entries.begin(), entries.end(), nullptr);
+    }
+
+    // 清理长期未使用的条目
+    if (cache.size() > kMaxCacheEntries) {
+        for (auto it = cache.begin(); it != cache.end();) {
+            if (frameIndex - it->second.lastUsedFrame > kCacheExpireFrames) {
+                it = cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    PerfCounters& counters = GetPerfCounters();
+    counters.subtitleCacheHits.fetch_add(hits, std::memory_order_relaxed);
+    counters.subtitleCacheMisses.fetch_add(misses, std::memory_order_relaxed);
+}
@@ -0,0 +1,34 @@
+#include "ui/subtitle_layout.hpp"
+#include <algorithm>
+
+SubtitleRect PlaceSubtitleBitmap(const SubtitleBitmap& bitmap, const SubtitleEvent& event,
+                                 const SubtitleViewport& viewport, const CropRect& crop,
+                                 int frameWidth, int frameHeight) {
+    float scale = crop.width > 0 ? viewport.width / crop.width : 1.0f;
+    float canvasScaleX = event.canvasWidth > 0 ? (float)frameWidth / event.canvasWidth : 1.0f;
+    float canvasScaleY = event.canvasHeight > 0 ? (float)frameHeight / event.canvasHeight : 1.0f;
+
+    float width = bitmap.width * canvasScaleX * scale;
+    float height = bitmap.height * canvasScaleY * scale;
+    float x0 = (bitmap.x * canvasScaleX - crop.x) * scale + viewport.x;
+    float y0 = (bitmap.y * canvasScaleY - crop.y) * scale + viewport.y;
+
+    if (width > viewport.width || height > viewport.height) {
+        float fit = std::min(viewport.width / width, viewport.height / height);
+        x0 += width * (1.0f - fit) * 0.5f;
+        y0 += height * (1.0f - fit) * 0.5f;
+        width *= fit;
+        height *= fit;
+    }
+
+    // 先贴住右/下边，再贴住左/上边：尺寸因舍入略大于 viewport 时以左上角为准
+    x0 = std::max(viewport.x, std::min(x0, viewport.x + viewport.width - width));
+    y0 = std::max(viewport.y, std::min(y0, viewport.y + viewport.height - height));
+
+    SubtitleRect rect;
+    rect.x0 = x0;
+    rect.y0 = y0;
+    rect.x1 = x0 + width;
+    rect.y1 = y0 + height;
+    return rect;
+}
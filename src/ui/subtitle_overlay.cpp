@@ -0,0 +1,174 @@
+#include "ui/subtitle_overlay.hpp"
+#include "imgui_internal.h"
+#include "utils/perf_counters.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// 图集边长（像素）
+static const int kAtlasSize = SubtitleCache::kAtlasSize;
+// 文本排版使用的字号，绘制时再按视频高度缩放
+static const float kLayoutFontSize = 32.0f;
+
+// 文本绘制的各遍：四个方向偏移的黑色描边，最后是白色正文
+struct TextPass {
+    ImVec2 offset;
+    ImU32 color;
+};
+static const TextPass kTextPasses[] = {
+    { ImVec2(-2, 0), IM_COL32(0, 0, 0, 255) },
+    { ImVec2(2, 0), IM_COL32(0, 0, 0, 255) },
+    { ImVec2(0, -2), IM_COL32(0, 0, 0, 255) },
+    { ImVec2(0, 2), IM_COL32(0, 0, 0, 255) },
+    { ImVec2(0, 0), IM_COL32(255, 255, 255, 255) },
+};
+static const int kTextPassCount = sizeof(kTextPasses) / sizeof(kTextPasses[0]);
+
+SubtitleOverlay::~SubtitleOverlay() {
+    Shutdown();
+}
+
+bool SubtitleOverlay::Initialize(ID3D11Device* device, ID3D11DeviceContext* context) {
+    d3dDevice = device;
+    d3dContext = context;
+
+    // 位图字幕图集，格式与调色板 0xAARRGGBB 的内存布局一致
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = kAtlasSize;
+    textureDesc.Height = kAtlasSize;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    if (FAILED(d3dDevice->CreateTexture2D(&textureDesc, nullptr, &atlasTexture))) {
+        return false;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = textureDesc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = 1;
+
+    if (FAILED(d3dDevice->CreateShaderResourceView(atlasTexture, &srvDesc, &atlasView))) {
+        return false;
+    }
+
+    cache.Clear();
+    cache.SetUploadFunction([this](const SubtitleBitmap& bitmap, int x, int y) {
+        UploadBitmap(bitmap, x, y);
+    });
+    // 按排版字号取出每个字形的四边形，之后每帧直接回放，不再逐字查找字形。
+    // 未设置字幕字体时与绘制一致，使用 ImGui 当前字体
+    cache.SetLayoutFunction([this](const char* begin, const char* end, std::vector<SubtitleCache::GlyphQuad>& glyphs) {
+        ImFont* layoutFont = font ? font : ImGui::GetFont();
+        float scale = kLayoutFontSize / layoutFont->FontSize;
+        float x = 0.0f;
+        for (const char* s = begin; s < end;) {
+            unsigned int c = (unsigned char)*s;
+            if (c < 0x80) {
+                s++;
+            } else {
+                s += ImTextCharFromUtf8(&c, s, end);
+                if (c == 0) break;
+            }
+            const ImFontGlyph* glyph = layoutFont->FindGlyph((ImWchar)c);
+            if (!glyph) continue;
+            if (glyph->X1 > glyph->X0 && glyph->Y1 > glyph->Y0) {
+                SubtitleCache::GlyphQuad quad;
+                quad.x0 = x + glyph->X0 * scale;
+                quad.y0 = glyph->Y0 * scale;
+                quad.x1 = x + glyph->X1 * scale;
+                quad.y1 = glyph->Y1 * scale;
+                quad.u0 = glyph->U0;
+                quad.v0 = glyph->V0;
+                quad.u1 = glyph->U1;
+                quad.v1 = glyph->V1;
+                glyphs.push_back(quad);
+            }
+            x += glyph->AdvanceX * scale;
+        }
+        return x;
+    });
+    return true;
+}
+
+void SubtitleOverlay::Shutdown() {
+    if (atlasView) atlasView->Release();
+    if (atlasTexture) atlasTexture->Release();
+    atlasView = nullptr;
+    atlasTexture = nullptr;
+    cache.Clear();
+}
+
+void SubtitleOverlay::UploadBitmap(const SubtitleBitmap& bitmap, int x, int y) {
+    D3D11_BOX box = { (UINT)x, (UINT)y, 0, (UINT)(x + bitmap.pixelWidth), (UINT)(y + bitmap.pixelHeight), 1 };
+    d3dContext->UpdateSubresource(atlasTexture, 0, &box, bitmap.pixels.data(), bitmap.pixelWidth * 4, 0);
+}
+
+void SubtitleOverlay::Render(ImDrawList* drawList, const std::vector<const SubtitleEvent*>& events,
+                             const D3D11_VIEWPORT& viewport, const CropRect& crop, int frameWidth, int frameHeight) {
+    if (!atlasView || !drawList) return;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // 第一遍：确保所有事件已缓存
+    std::vector<const SubtitleCache::Entry*>& entries = frameEntries;
+    cache.Prepare(events, entries);
+
+    // 第二遍：批量绘制。文本四边形使用字体图集纹理
+    ImFont* textFont = font ? font : ImGui::GetFont();
+    drawList->PushTextureID(textFont->ContainerAtlas->TexID);
+
+    SubtitleViewport videoArea;
+    videoArea.x = viewport.TopLeftX;
+    videoArea.y = viewport.TopLeftY;
+    videoArea.width = viewport.Width;
+    videoArea.height = viewport.Height;
+    float fontSize = viewport.Height * 0.05f;
+    float textScale = fontSize / kLayoutFontSize;
+    float textBottom = viewport.TopLeftY + viewport.Height * 0.95f;
+    float centerX = viewport.TopLeftX + viewport.Width * 0.5f;
+
+    for (size_t i = 0; i < events.size(); i++) {
+        const SubtitleEvent& event = *events[i];
+        const SubtitleCache::Entry* entry = entries[i];
+        if (!entry) continue;
+
+        // 位图映射到窗口，落在裁掉的黑边里的平移回视频区域
+        for (size_t b = 0; b < entry->bitmaps.size() && b < event.bitmaps.size(); b++) {
+            SubtitleRect rect = PlaceSubtitleBitmap(event.bitmaps[b], event, videoArea, crop, frameWidth, frameHeight);
+            const SubtitleCache::CachedBitmap& cached = entry->bitmaps[b];
+            drawList->AddImage((ImTextureID)(intptr_t)atlasView, ImVec2(rect.x0, rect.y0), ImVec2(rect.x1, rect.y1),
+                               ImVec2(cached.u0, cached.v0), ImVec2(cached.u1, cached.v1));
+        }
+
+        // 文本自下而上逐行居中：回放缓存的字形四边形，描边与正文共用一次预留
+        float y = textBottom - fontSize * entry->lines.size();
+        for (const auto& line : entry->lines) {
+            float x = std::floor(centerX - line.width * textScale * 0.5f);
+            int quadCount = (int)line.glyphs.size() * kTextPassCount;
+            if (quadCount > 0) {
+                drawList->PrimReserve(quadCount * 6, quadCount * 4);
+                for (const TextPass& pass : kTextPasses) {
+                    float originX = x + pass.offset.x;
+                    float originY = y + pass.offset.y;
+                    for (const auto& glyph : line.glyphs) {
+                        drawList->PrimRectUV(
+                            ImVec2(originX + glyph.x0 * textScale, originY + glyph.y0 * textScale),
+                            ImVec2(originX + glyph.x1 * textScale, originY + glyph.y1 * textScale),
+                            ImVec2(glyph.u0, glyph.v0), ImVec2(glyph.u1, glyph.v1), pass.color);
+                    }
+                }
+            }
+            y += fontSize;
+        }
+    }
+    drawList->PopTextureID();
+
+    PerfCounters& counters = GetPerfCounters();
+    counters.subtitleOverlayMicros.store(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+}
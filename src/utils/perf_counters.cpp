@@ -0,0 +1,119 @@
+#include "utils/perf_counters.hpp"
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+PerfCounters& GetPerfCounters() {
+    // 函数内静态对象，保证首次 operator new 之前已完成初始化
+    static PerfCounters counters;
+    return counters;
+}
+
+PerfSnapshot TakePerfSnapshot() {
+    const PerfCounters& counters = GetPerfCounters();
+    PerfSnapshot snapshot;
+    snapshot.heapAllocations = counters.heapAllocations.load(std::memory_order_relaxed);
+    snapshot.heapBytes = counters.heapBytes.load(std::memory_order_relaxed);
+    snapshot.frameBuffers = counters.frameBuffers.load(std::memory_order_relaxed);
+    snapshot.frameBufferBytes = counters.frameBufferBytes.load(std::memory_order_relaxed);
+    snapshot.convertedBytes = counters.convertedBytes.load(std::memory_order_relaxed);
+    snapshot.uploadedBytes = counters.uploadedBytes.load(std::memory_order_relaxed);
+    snapshot.renderedFrames = counters.renderedFrames.load(std::memory_order_relaxed);
+    snapshot.cropSavedBytes = counters.cropSavedBytes.load(std::memory_order_relaxed);
+    snapshot.cropDetectMicros = counters.cropDetectMicros.load(std::memory_order_relaxed);
+    snapshot.cropScanMicros = counters.cropScanMicros.load(std::memory_order_relaxed);
+    snapshot.subtitleCacheHits = counters.subtitleCacheHits.load(std::memory_order_relaxed);
+    snapshot.subtitleCacheMisses = counters.subtitleCacheMisses.load(std::memory_order_relaxed);
+    snapshot.subtitleOverlayMicros = counters.subtitleOverlayMicros.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+// 替换全局 operator new/delete，统计整个程序的 C++ 堆分配
+static void* CountedAlloc(size_t size) {
+    PerfCounters& counters = GetPerfCounters();
+    counters.heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.heapBytes.fetch_add(size, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void* operator new(size_t size) {
+    void* p = CountedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = CountedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return CountedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return CountedAlloc(size);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+// 超对齐类型（alignas 大于默认对齐）走 align_val_t 重载，同样计入统计
+static void* CountedAlignedAlloc(size_t size, std::align_val_t alignment) {
+    PerfCounters& counters = GetPerfCounters();
+    counters.heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.heapBytes.fetch_add(size, std::memory_order_relaxed);
+
+    size_t align = (size_t)alignment;
+    if (align < sizeof(void*)) align = sizeof(void*);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, align, size ? size : 1) != 0) return nullptr;
+    return p;
+#endif
+}
+
+static void AlignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* p = CountedAlignedAlloc(size, alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    void* p = CountedAlignedAlloc(size, alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAlignedAlloc(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(p); }
@@ -0,0 +1,86 @@
+#include "utils/thread_pool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+
+    workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) return;
+    if (count == 1 || workers.empty()) {
+        for (int i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> serial(batchMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batchFn = &fn;
+        batchCount = count;
+        batchNext = 0;
+        batchRemaining = count;
+        batchSlots = std::min((int)workers.size(), count - 1);
+    }
+    taskCondition.notify_all();
+
+    DrainBatch(fn, count);
+
+    // 不再接纳新的工作线程，并等待已加入的全部退出，之后才能复用批次状态
+    std::unique_lock<std::mutex> lock(mutex);
+    batchSlots = 0;
+    batchDone.wait(lock, [this]() { return batchRemaining.load() == 0 && batchHelpers == 0; });
+    batchFn = nullptr;
+}
+
+void ThreadPool::DrainBatch(const std::function<void(int)>& fn, int count) {
+    // 每个参与者循环领取下标，直到全部领完
+    int index;
+    while ((index = batchNext.fetch_add(1)) < count) {
+        fn(index);
+        batchRemaining.fetch_sub(1);
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        taskCondition.wait(lock, [this]() { return stopping || batchSlots > 0; });
+
+        if (batchSlots > 0) {
+            batchSlots--;
+            batchHelpers++;
+            const std::function<void(int)>& fn = *batchFn;
+            int count = batchCount;
+            lock.unlock();
+            DrainBatch(fn, count);
+            lock.lock();
+            if (--batchHelpers == 0) {
+                batchDone.notify_all();
+            }
+            continue;
+        }
+
+        if (stopping) return;
+    }
+}
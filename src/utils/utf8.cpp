@@ -0,0 +1,43 @@
+#include "utils/utf8.hpp"
+#include <cstdint>
+
+#ifdef _WIN32
+#include <Windows.h>
+
+std::string ToUtf8(const std::wstring& text) {
+    if (text.empty()) return std::string();
+
+    int size = WideCharToMultiByte(CP_UTF8, 0, text.c_str(), (int)text.size(), NULL, 0, NULL, NULL);
+    std::string result(size, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, text.c_str(), (int)text.size(), &result[0], size, NULL, NULL);
+    return result;
+}
+
+#else
+
+// 非 Windows 平台 wchar_t 为 UTF-32
+std::string ToUtf8(const std::wstring& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (wchar_t ch : text) {
+        uint32_t c = (uint32_t)ch;
+        if (c < 0x80) {
+            result += (char)c;
+        } else if (c < 0x800) {
+            result += (char)(0xC0 | (c >> 6));
+            result += (char)(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            result += (char)(0xE0 | (c >> 12));
+            result += (char)(0x80 | ((c >> 6) & 0x3F));
+            result += (char)(0x80 | (c & 0x3F));
+        } else {
+            result += (char)(0xF0 | (c >> 18));
+            result += (char)(0x80 | ((c >> 12) & 0x3F));
+            result += (char)(0x80 | ((c >> 6) & 0x3F));
+            result += (char)(0x80 | (c & 0x3F));
+        }
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,97 @@
+// 转换线程数扩展性基准：1080p/4K/8K 合成帧在不同线程数下的每帧耗时
+// 用法：convert_benchmark [--quick] [--threads N]
+// --quick 只跑 1080p 与少量迭代，供 CTest 冒烟；--threads 指定最大线程数，默认硬件线程数
+#include "decoder/frame_converter.hpp"
+#include "test_media.hpp"
+#include "test_utils.hpp"
+#include "utils/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+}
+
+struct Resolution {
+    const char* name;
+    int width;
+    int height;
+};
+
+// 返回每帧平均耗时（毫秒）
+static double MeasureConvert(const AVFrame* frame, unsigned threadCount, int iterations) {
+    ThreadPool pool(threadCount);
+    FrameConverter converter(threadCount > 1 ? &pool : nullptr);
+
+    int pitch = frame->width * 4;
+    std::vector<uint8_t> dest((size_t)pitch * frame->height);
+
+    // 首次转换包含上下文创建，不计入
+    CHECK(converter.Convert(frame, dest.data(), pitch, frame->width, frame->height));
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        CHECK(converter.Convert(frame, dest.data(), pitch, frame->width, frame->height));
+    }
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / iterations;
+}
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            maxThreads = (unsigned)std::max(1, std::atoi(argv[++i]));
+        }
+    }
+
+    std::vector<Resolution> resolutions = { { "1080p", 1920, 1080 } };
+    if (!quick) {
+        resolutions.push_back({ "4K", 3840, 2160 });
+        resolutions.push_back({ "8K", 7680, 4320 });
+    }
+
+    // 两种格式分别覆盖条带切分与 swscale 切片多线程
+    const AVPixelFormat formats[] = { AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV420P10LE };
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned n = 1; n < maxThreads; n *= 2) {
+        threadCounts.push_back(n);
+    }
+    threadCounts.push_back(maxThreads);
+    if (quick && threadCounts.size() > 2) {
+        threadCounts = { 1, maxThreads };
+    }
+
+    std::printf("%-6s %-14s %8s %10s %8s\n", "size", "format", "threads", "ms/frame", "speedup");
+    for (const Resolution& resolution : resolutions) {
+        for (AVPixelFormat format : formats) {
+            TestVideoOptions options;
+            options.width = resolution.width;
+            options.height = resolution.height;
+            options.pixelFormat = format;
+            AVFrame* frame = CreateTestFrame(options, 0);
+            CHECK(frame != nullptr);
+
+            int iterations = quick ? 3 : std::max(5, 200 * 1920 * 1080 / (resolution.width * resolution.height));
+            double baseline = 0;
+            for (unsigned threads : threadCounts) {
+                double ms = MeasureConvert(frame, threads, iterations);
+                if (threads == 1) baseline = ms;
+                std::printf("%-6s %-14s %8u %10.2f %7.2fx\n", resolution.name, av_get_pix_fmt_name(format),
+                            threads, ms, baseline > 0 ? baseline / ms : 1.0);
+            }
+            av_frame_free(&frame);
+        }
+    }
+    return 0;
+}
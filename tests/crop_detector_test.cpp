@@ -0,0 +1,88 @@
+// 黑边检测：8 位格式按内容裁剪；不支持的格式（如 10 位）退回整帧，解码器输出完整尺寸
+#include "decoder/crop_detector.hpp"
+#include "decoder/ffmpeg_decoder.hpp"
+#include "test_media.hpp"
+#include "test_utils.hpp"
+#include "utils/perf_counters.hpp"
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+}
+
+static bool SameRect(const CropRect& a, const CropRect& b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+static CropRect DetectFrame(const TestVideoOptions& options, bool* accepted) {
+    AVFrame* frame = CreateTestFrame(options, 0);
+    CHECK(frame != nullptr);
+    CropDetector detector;
+    *accepted = detector.Feed(frame);
+    av_frame_free(&frame);
+    return detector.GetCrop();
+}
+
+static void CheckDetector() {
+    TestVideoOptions options;
+    options.width = 352;
+    options.height = 288;
+    options.barRows = 36;
+    options.barColumns = 20;
+    bool accepted = false;
+
+    // 8 位：上下左右黑边都被裁掉
+    CropRect crop = DetectFrame(options, &accepted);
+    CHECK(accepted);
+    CHECK(SameRect(crop, CropRect{ 20, 36, 312, 216 }));
+
+    // 10 位：格式被拒绝，裁剪区域为整帧而不是 0x0
+    options.pixelFormat = AV_PIX_FMT_YUV420P10LE;
+    crop = DetectFrame(options, &accepted);
+    CHECK(!accepted);
+    CHECK(SameRect(crop, CropRect{ 0, 0, 352, 288 }));
+}
+
+static void CheckDecoderSize(AVPixelFormat format, int expectedWidth, int expectedHeight) {
+    TestVideoOptions options;
+    options.width = 352;
+    options.height = 288;
+    options.barRows = 36;
+    options.pixelFormat = format;
+    std::string path = TestFilePath(std::string("crop_") + av_get_pix_fmt_name(format) + ".mkv");
+    CHECK(WriteTestVideo(path, options));
+
+    FFmpegDecoder decoder;
+    CHECK(decoder.OpenFile(std::wstring(path.begin(), path.end())));
+
+    int width = 0, height = 0;
+    CHECK(decoder.DecodeFirstFrame(&width, &height));
+    CHECK(width == expectedWidth);
+    CHECK(height == expectedHeight);
+
+    uint64_t savedBytes = ((uint64_t)options.width * options.height - (uint64_t)width * height) * 4;
+    PerfSnapshot snapshot = TakePerfSnapshot();
+    CHECK(snapshot.cropSavedBytes == savedBytes);
+    // 检测耗时包含取样的定位与解码，不只是亮度扫描
+    CHECK(snapshot.cropDetectMicros > 0);
+    CHECK(snapshot.cropDetectMicros >= snapshot.cropScanMicros);
+
+    std::vector<uint8_t> pixels((size_t)width * 4 * height);
+    CHECK(decoder.ConvertFrame(pixels.data(), width * 4, width, height));
+
+    decoder.Cleanup();
+    std::remove(path.c_str());
+}
+
+int main() {
+    CheckDetector();
+
+    // 8 位带黑边的文件输出裁剪后的尺寸；10 位文件不裁剪，保持完整尺寸
+    CheckDecoderSize(AV_PIX_FMT_YUV420P, 352, 216);
+    CheckDecoderSize(AV_PIX_FMT_YUV420P10LE, 352, 288);
+
+    std::printf("crop_detector_test passed\n");
+    return 0;
+}
@@ -0,0 +1,46 @@
+// 逐帧解码到文件末尾：解码器缓冲的帧（B 帧延迟输出）必须在结束前全部取出
+#include "decoder/ffmpeg_decoder.hpp"
+#include "test_media.hpp"
+#include "test_utils.hpp"
+#include <cstdio>
+
+static void CheckAllFramesDecoded(const TestVideoOptions& options, const char* name) {
+    std::string path = TestFilePath(name);
+    CHECK(WriteTestVideo(path, options));
+
+    FFmpegDecoder decoder;
+    CHECK(decoder.OpenFile(std::wstring(path.begin(), path.end())));
+
+    int width = 0, height = 0;
+    CHECK(decoder.DecodeFirstFrame(&width, &height));
+
+    int frames = 1;
+    double lastTime = decoder.GetFrameTime();
+    while (decoder.DecodeFrame()) {
+        CHECK(decoder.GetFrameTime() > lastTime);
+        lastTime = decoder.GetFrameTime();
+        frames++;
+    }
+    if (frames != options.frameCount) {
+        std::fprintf(stderr, "%s: decoded %d of %d frames\n", name, frames, options.frameCount);
+        std::exit(1);
+    }
+
+    // 冲刷完毕后继续调用保持返回 false
+    CHECK(!decoder.DecodeFrame());
+
+    decoder.Cleanup();
+    std::remove(path.c_str());
+}
+
+int main() {
+    TestVideoOptions options;
+    options.frameCount = 12;
+    CheckAllFramesDecoded(options, "eof_intra.mkv");
+
+    options.bFrames = 2;
+    CheckAllFramesDecoded(options, "eof_bframes.mkv");
+
+    std::printf("decoder_eof_test passed\n");
+    return 0;
+}
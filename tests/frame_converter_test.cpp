@@ -0,0 +1,103 @@
+// 并行转换必须与单线程转换逐字节一致：覆盖条带切分与 swscale 切片多线程两条路径
+#include "decoder/frame_converter.hpp"
+#include "test_media.hpp"
+#include "test_utils.hpp"
+#include "utils/thread_pool.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+}
+
+struct Case {
+    AVPixelFormat format;
+    int height;
+    bool expectSwscaleThreads;  // 是否应交给 swscale 自带的切片多线程
+};
+
+static void CheckSameOutput(ThreadPool& pool, const Case& test, const CropRect& crop) {
+    TestVideoOptions options;
+    options.width = 352;
+    options.height = test.height;
+    options.pixelFormat = test.format;
+    options.barRows = 24;
+    AVFrame* frame = CreateTestFrame(options, 1);
+    CHECK(frame != nullptr);
+
+    int width = crop.width > 0 ? crop.width : options.width;
+    int height = crop.height > 0 ? crop.height : options.height;
+    int pitch = width * 4 + 32;
+    std::vector<uint8_t> expected((size_t)pitch * height, 0);
+    std::vector<uint8_t> actual((size_t)pitch * height, 0);
+
+    FrameConverter single;
+    single.SetCrop(crop);
+    CHECK(single.Convert(frame, expected.data(), pitch, width, height));
+    CHECK(single.GetBandCount() == 1);
+
+    FrameConverter parallel(&pool);
+    parallel.SetCrop(crop);
+    // 连续转换两次，确认复用的上下文与帧描述不残留状态
+    for (int pass = 0; pass < 2; pass++) {
+        std::memset(actual.data(), 0, actual.size());
+        CHECK(parallel.Convert(frame, actual.data(), pitch, width, height));
+        CHECK(parallel.UsesSwscaleThreads() == test.expectSwscaleThreads);
+        if (!test.expectSwscaleThreads) {
+            CHECK(parallel.GetBandCount() > 1);
+        }
+
+        for (int y = 0; y < height; y++) {
+            if (std::memcmp(expected.data() + (size_t)y * pitch, actual.data() + (size_t)y * pitch, (size_t)width * 4) != 0) {
+                std::fprintf(stderr, "%s %dx%d: row %d differs\n",
+                             av_get_pix_fmt_name(test.format), width, height, y);
+                std::exit(1);
+            }
+        }
+    }
+
+    av_frame_free(&frame);
+}
+
+int main() {
+    ThreadPool pool(4);
+
+    const Case cases[] = {
+        { AV_PIX_FMT_YUV420P,     288, false },
+        { AV_PIX_FMT_YUV420P,     287, true  },  // 奇数高度不走 yuv2rgb 专用路径
+        { AV_PIX_FMT_YUVJ420P,    288, false },
+        { AV_PIX_FMT_YUV422P,     288, false },
+        { AV_PIX_FMT_YUV422P,     287, true  },
+        { AV_PIX_FMT_YUV444P,     287, false },
+        { AV_PIX_FMT_YUV420P10LE, 288, true  },  // 通用路径条带末两行与整帧转换不同
+        { AV_PIX_FMT_NV12,        288, true  },
+        { AV_PIX_FMT_P010LE,      288, true  },
+    };
+
+    for (const Case& test : cases) {
+        CheckSameOutput(pool, test, CropRect{});
+        // 裁剪起点按色度子采样对齐，与 CropDetector 的输出一致
+        CheckSameOutput(pool, test, CropRect{ 16, 24, 320, test.height - 48 });
+    }
+
+    // 裁剪区域超出当前帧（如 1920x800 的裁剪遇到 1920x936 的帧）时不能退回整帧，
+    // 即使目标恰好是整帧大小也必须拒绝
+    TestVideoOptions options;
+    options.width = 352;
+    options.height = 200;
+    AVFrame* frame = CreateTestFrame(options, 0);
+    CHECK(frame != nullptr);
+    std::vector<uint8_t> dest((size_t)options.width * 4 * options.height, 0xCD);
+    FrameConverter converter(&pool);
+    converter.SetCrop(CropRect{ 0, 36, 352, 216 });
+    CHECK(!converter.Convert(frame, dest.data(), options.width * 4, options.width, options.height));
+    CHECK(!converter.Convert(frame, dest.data(), 352 * 4, 352, 216));
+    CHECK(std::all_of(dest.begin(), dest.end(), [](uint8_t b) { return b == 0xCD; }));
+    av_frame_free(&frame);
+
+    std::printf("frame_converter_test passed\n");
+    return 0;
+}
@@ -0,0 +1,70 @@
+// 解码帧直接写入（模拟的）映射纹理内存：检查每帧写入量、行距与写入范围
+#include "decoder/ffmpeg_decoder.hpp"
+#include "mock_mapped_surface.hpp"
+#include "test_media.hpp"
+#include "test_utils.hpp"
+#include "utils/perf_counters.hpp"
+#include "utils/thread_pool.hpp"
+#include <cstdio>
+
+int main() {
+    TestVideoOptions options;
+    options.width = 322;
+    options.height = 182;
+    options.frameCount = 3;
+    std::string path = TestFilePath("frame_writer_test.mkv");
+    CHECK(WriteTestVideo(path, options));
+
+    ThreadPool pool(4);
+    FFmpegDecoder decoder(&pool);
+    CHECK(decoder.OpenFile(std::wstring(path.begin(), path.end())));
+
+    int width = 0, height = 0;
+    CHECK(decoder.DecodeFirstFrame(&width, &height));
+    CHECK(width == options.width);
+    CHECK(height == options.height);
+
+    MockMappedSurface surface(width, height);
+    FrameWriter writeFrame = [&](uint8_t* dest, int pitch, int surfaceWidth, int surfaceHeight) {
+        return decoder.ConvertFrame(dest, pitch, surfaceWidth, surfaceHeight);
+    };
+
+    // 每帧只有一次转换写入，且恰好是一帧 BGRA 的大小
+    for (int i = 0; i < 3; i++) {
+        PerfSnapshot before = TakePerfSnapshot();
+        CHECK(surface.Upload(writeFrame));
+        PerfSnapshot after = TakePerfSnapshot();
+
+        uint64_t frameBytes = (uint64_t)width * 4 * height;
+        CHECK(after.convertedBytes - before.convertedBytes == frameBytes);
+        CHECK(surface.CountWrittenBytes() <= (uint64_t)surface.GetPitch() * height);
+        CHECK(surface.GuardIntact());
+
+        for (int y = 0; y < height; y++) {
+            const uint8_t* row = surface.Row(y);
+            for (int x = 0; x < width; x++) {
+                CHECK(row[x * 4 + 3] == 255);
+            }
+        }
+    }
+
+    // 帧比映射纹理大（如纹理按旧尺寸创建）时必须拒绝，且一个字节都不写
+    MockMappedSurface shorterSurface(width, height - 16);
+    CHECK(!shorterSurface.Upload(writeFrame));
+    CHECK(shorterSurface.CountWrittenBytes() == 0);
+
+    MockMappedSurface narrowerSurface(width - 2, height);
+    CHECK(!narrowerSurface.Upload(writeFrame));
+    CHECK(narrowerSurface.CountWrittenBytes() == 0);
+
+    // 转换失败必须如实返回，调用方据此保留“待上传”标记
+    FFmpegDecoder emptyDecoder;
+    FrameWriter failingWriter = [&](uint8_t* dest, int pitch, int surfaceWidth, int surfaceHeight) {
+        return emptyDecoder.ConvertFrame(dest, pitch, surfaceWidth, surfaceHeight);
+    };
+    CHECK(!surface.Upload(failingWriter));
+
+    std::remove(path.c_str());
+    std::printf("frame_writer_test passed\n");
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "malloc_counter.hpp"
+#include <atomic>
+
+#if defined(__GLIBC__)
+#include <cerrno>
+#include <cstddef>
+
+// glibc 导出的原始实现
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+
+static std::atomic<uint64_t> mallocCount{ 0 };
+
+extern "C" {
+
+void* malloc(size_t size) {
+    mallocCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    mallocCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    mallocCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    mallocCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    mallocCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+    mallocCount.fetch_add(1, std::memory_order_relaxed);
+    void* result = __libc_memalign(alignment, size);
+    if (!result) return ENOMEM;
+    *pointer = result;
+    return 0;
+}
+
+void free(void* pointer) {
+    __libc_free(pointer);
+}
+
+}
+
+bool MallocCountingAvailable() {
+    return true;
+}
+
+uint64_t GetMallocCount() {
+    return mallocCount.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool MallocCountingAvailable() {
+    return false;
+}
+
+uint64_t GetMallocCount() {
+    return 0;
+}
+
+#endif
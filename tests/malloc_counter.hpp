@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+// 统计 C 运行库层面的堆分配（malloc/calloc/realloc/posix_memalign 等）。
+// av_malloc 与全局 operator new 最终都经由这些函数，因此能覆盖 FFmpeg 内部的分配。
+// 仅在 glibc 下可用：测试程序自行定义这些函数，动态链接时 FFmpeg 共享库的调用也会解析到这里
+
+// 当前平台是否支持统计；不支持时 GetMallocCount 恒为 0
+bool MallocCountingAvailable();
+// 进程启动以来的分配次数（realloc 计一次）
+uint64_t GetMallocCount();
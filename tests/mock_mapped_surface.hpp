@@ -0,0 +1,50 @@
+#pragma once
+#include "renderer/frame_writer.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 模拟 D3D11 映射后的纹理内存：行距大于一行像素，映射区之后另有一段保护区。
+// 每次上传前整块填充哨兵字节，用于检查写入范围与每帧写入量。
+// 行尾填充属于映射区，swscale 的 SIMD 实现可能在其中写入不足一个向量的尾部，
+// 因此只检查映射区之外的保护区
+class MockMappedSurface {
+public:
+    static const uint8_t kSentinel = 0xCD;
+    static const int kGuardBytes = 4096;
+
+    MockMappedSurface(int width, int height, int rowPadding = 64)
+        : surfaceWidth(width), surfaceHeight(height), pitch(width * 4 + rowPadding),
+          memory((size_t)pitch * height + kGuardBytes) {
+    }
+
+    // 与 D3D11Renderer::Render 一致：映射（内容未定义）→ 调用 writer → 解除映射
+    bool Upload(const FrameWriter& writer) {
+        std::fill(memory.begin(), memory.end(), kSentinel);
+        return writer(memory.data(), pitch, surfaceWidth, surfaceHeight);
+    }
+
+    // 映射区之后的保护区未被改写
+    bool GuardIntact() const {
+        return std::all_of(memory.begin() + (ptrdiff_t)pitch * surfaceHeight, memory.end(),
+                           [](uint8_t b) { return b == kSentinel; });
+    }
+
+    // 本次上传实际改写的字节数（与哨兵不同的字节，可能略少于真实写入量）
+    uint64_t CountWrittenBytes() const {
+        return (uint64_t)std::count_if(memory.begin(), memory.end(),
+                                       [](uint8_t b) { return b != kSentinel; });
+    }
+
+    const uint8_t* Row(int y) const { return memory.data() + (size_t)y * pitch; }
+    int GetPitch() const { return pitch; }
+    int GetWidth() const { return surfaceWidth; }
+    int GetHeight() const { return surfaceHeight; }
+
+private:
+    int surfaceWidth;
+    int surfaceHeight;
+    int pitch;
+    std::vector<uint8_t> memory;
+};
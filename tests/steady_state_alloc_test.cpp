@@ -0,0 +1,108 @@
+// 稳态播放不分配：预热后逐帧解码并转换到 CPU 缓冲，检查每帧的堆分配、解码缓冲与转换字节数。
+// glibc 下另外统计 malloc 层面的分配，覆盖 FFmpeg 内部的 av_malloc
+#include "decoder/ffmpeg_decoder.hpp"
+#include "malloc_counter.hpp"
+#include "mock_mapped_surface.hpp"
+#include "test_media.hpp"
+#include "test_utils.hpp"
+#include "utils/perf_counters.hpp"
+#include "utils/thread_pool.hpp"
+#include <cstdio>
+
+extern "C" {
+#include <libavutil/pixdesc.h>
+}
+
+// 每帧允许的上限；C++ 堆分配的上限与 PlayerUI 共用 PerfCounters::kMaxHeapAllocationsPerFrame
+static const uint64_t kMaxFrameBuffersPerFrame = 1;
+// 转换写入的 malloc 次数：条带路径不分配；swscale 切片多线程路径中，
+// sws_scale_frame 为源、目标帧各增加一次缓冲引用
+static const uint64_t kMaxSwscaleThreadsMallocsPerFrame = 2;
+// 解复用与解码的 malloc 次数（测试区间内的平均值），全部来自 FFmpeg 内部：
+// matroska 每个数据包新分配缓冲（约 7 次），送包时引用数据包、从帧池取缓冲（约 8 次），
+// FFV1 部分帧会重建内部状态（30 次以上）
+static const double kMaxDecodeMallocsPerFrame = 20.0;
+
+static const int kWarmupFrames = 5;
+static const int kMeasuredFrames = 20;
+
+static void CheckSteadyState(ThreadPool& pool, AVPixelFormat format) {
+    TestVideoOptions options;
+    options.width = 640;
+    options.height = 360;
+    options.frameCount = 1 + kWarmupFrames + kMeasuredFrames;
+    options.pixelFormat = format;
+    std::string path = TestFilePath(std::string("steady_state_") + av_get_pix_fmt_name(format) + ".mkv");
+    CHECK(WriteTestVideo(path, options));
+
+    FFmpegDecoder decoder(&pool);
+    CHECK(decoder.OpenFile(std::wstring(path.begin(), path.end())));
+
+    int width = 0, height = 0;
+    CHECK(decoder.DecodeFirstFrame(&width, &height));
+
+    MockMappedSurface surface(width, height);
+    FrameWriter writeFrame = [&decoder](uint8_t* dest, int pitch, int width, int height) {
+        return decoder.ConvertFrame(dest, pitch, width, height);
+    };
+    CHECK(surface.Upload(writeFrame));
+
+    // 预热：上下文、条带和解码器内部池在前几帧建立
+    for (int i = 0; i < kWarmupFrames; i++) {
+        CHECK(decoder.DecodeFrame());
+        CHECK(surface.Upload(writeFrame));
+    }
+
+    uint64_t frameBytes = (uint64_t)width * 4 * height;
+    uint64_t maxUploadMallocs = decoder.GetConverter().UsesSwscaleThreads() ? kMaxSwscaleThreadsMallocsPerFrame : 0;
+    uint64_t decodeMallocs = 0;
+    for (int i = 0; i < kMeasuredFrames; i++) {
+        PerfSnapshot before = TakePerfSnapshot();
+        uint64_t mallocsBefore = GetMallocCount();
+        CHECK(decoder.DecodeFrame());
+        uint64_t mallocsDecoded = GetMallocCount();
+        CHECK(surface.Upload(writeFrame));
+        uint64_t mallocsUploaded = GetMallocCount();
+        PerfSnapshot after = TakePerfSnapshot();
+
+        uint64_t allocations = after.heapAllocations - before.heapAllocations;
+        uint64_t frameBuffers = after.frameBuffers - before.frameBuffers;
+        uint64_t convertedBytes = after.convertedBytes - before.convertedBytes;
+        uint64_t uploadMallocs = mallocsUploaded - mallocsDecoded;
+        decodeMallocs += mallocsDecoded - mallocsBefore;
+        if (allocations > PerfCounters::kMaxHeapAllocationsPerFrame || frameBuffers > kMaxFrameBuffersPerFrame ||
+            convertedBytes != frameBytes || uploadMallocs > maxUploadMallocs) {
+            std::fprintf(stderr, "%s frame %d: %llu allocations, %llu frame buffers, %llu converted bytes, "
+                         "%llu upload mallocs\n",
+                         av_get_pix_fmt_name(format), i, (unsigned long long)allocations,
+                         (unsigned long long)frameBuffers, (unsigned long long)convertedBytes,
+                         (unsigned long long)uploadMallocs);
+            std::exit(1);
+        }
+    }
+
+    double decodeMallocsPerFrame = (double)decodeMallocs / kMeasuredFrames;
+    std::printf("%s: %.1f decode mallocs per frame, at most %llu per upload\n", av_get_pix_fmt_name(format),
+                decodeMallocsPerFrame, (unsigned long long)maxUploadMallocs);
+    if (decodeMallocsPerFrame > kMaxDecodeMallocsPerFrame) {
+        std::fprintf(stderr, "%s: %.1f decode mallocs per frame\n", av_get_pix_fmt_name(format), decodeMallocsPerFrame);
+        std::exit(1);
+    }
+
+    decoder.Cleanup();
+    std::remove(path.c_str());
+}
+
+int main() {
+    if (!MallocCountingAvailable()) {
+        std::printf("malloc counting unavailable, checking operator new only\n");
+    }
+
+    ThreadPool pool(4);
+    // 分别覆盖条带切分与 swscale 切片多线程两条转换路径
+    CheckSteadyState(pool, AV_PIX_FMT_YUV420P);
+    CheckSteadyState(pool, AV_PIX_FMT_YUV420P10LE);
+
+    std::printf("steady_state_alloc_test passed\n");
+    return 0;
+}
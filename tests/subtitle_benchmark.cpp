@@ -0,0 +1,386 @@
+// 字幕叠加缓存基准：不依赖 D3D，按 60fps 模拟播放密集字幕，统计缓存命中率与每帧叠加耗时；
+// 另外经 FFmpegDecoder 解码一个带 SubRip 字幕流的合成文件，覆盖真实的字幕解码路径
+// 用法：subtitle_benchmark [--quick]（--quick 只模拟 60 秒，供 CTest 冒烟）
+#include "decoder/ffmpeg_decoder.hpp"
+#include "decoder/subtitle_track.hpp"
+#include "test_media.hpp"
+#include "test_utils.hpp"
+#include "ui/subtitle_cache.hpp"
+#include "ui/subtitle_layout.hpp"
+#include "utils/perf_counters.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+static const double kFrameRate = 60.0;
+// 与 SubtitleOverlay 相同：每行文本绘制 5 遍（四向描边 + 正文）
+static const int kTextPassCount = 5;
+// 模拟排版的字形宽度（像素）
+static const float kGlyphAdvance = 16.0f;
+
+struct Vertex {
+    float x, y, u, v;
+};
+
+// 模拟排版：每个字节一个字形，记录排版次数
+static SubtitleCache::LayoutFunction CountingLayout(uint64_t* layoutCalls) {
+    return [layoutCalls](const char* begin, const char* end, std::vector<SubtitleCache::GlyphQuad>& glyphs) {
+        (*layoutCalls)++;
+        float x = 0.0f;
+        for (const char* s = begin; s < end; s++) {
+            SubtitleCache::GlyphQuad quad;
+            quad.x0 = x;
+            quad.x1 = x + kGlyphAdvance;
+            quad.y1 = 32.0f;
+            quad.u0 = (float)(unsigned char)*s / 256.0f;
+            quad.u1 = quad.u0 + 1.0f / 256.0f;
+            quad.v1 = 1.0f;
+            glyphs.push_back(quad);
+            x += kGlyphAdvance;
+        }
+        return x;
+    };
+}
+
+// 与 SubtitleOverlay 的绘制循环相同：每遍把缓存的字形四边形平移、缩放后写入顶点
+static void ReplayText(const SubtitleCache::Entry& entry, float scale, std::vector<Vertex>& vertices) {
+    static const float kOffsets[kTextPassCount][2] = { { -2, 0 }, { 2, 0 }, { 0, -2 }, { 0, 2 }, { 0, 0 } };
+    float y = 0.0f;
+    for (const auto& line : entry.lines) {
+        float x = std::floor(960.0f - line.width * scale * 0.5f);
+        for (const auto& offset : kOffsets) {
+            for (const auto& glyph : line.glyphs) {
+                float x0 = x + offset[0] + glyph.x0 * scale;
+                float y0 = y + offset[1] + glyph.y0 * scale;
+                float x1 = x + offset[0] + glyph.x1 * scale;
+                float y1 = y + offset[1] + glyph.y1 * scale;
+                vertices.push_back(Vertex{ x0, y0, glyph.u0, glyph.v0 });
+                vertices.push_back(Vertex{ x1, y0, glyph.u1, glyph.v0 });
+                vertices.push_back(Vertex{ x1, y1, glyph.u1, glyph.v1 });
+                vertices.push_back(Vertex{ x0, y1, glyph.u0, glyph.v1 });
+            }
+        }
+        y += 32.0f * scale;
+    }
+}
+
+// 加入一条 ASS 文本事件
+static void AddText(SubtitleTrack& track, double start, double duration, const std::string& text) {
+    std::string ass = "0,0,Default,,0,0,0,," + text;
+    AVSubtitleRect rect = {};
+    rect.type = SUBTITLE_ASS;
+    rect.ass = &ass[0];
+    AVSubtitleRect* rects[] = { &rect };
+
+    AVSubtitle subtitle = {};
+    subtitle.end_display_time = (uint32_t)(duration * 1000);
+    subtitle.num_rects = 1;
+    subtitle.rects = rects;
+    track.AddSubtitle(subtitle, start, 0.0, 0, 0);
+}
+
+// 加入一条单区域位图事件（PGS 风格，调色板索引）
+static void AddBitmap(SubtitleTrack& track, double start, double duration, int width, int height) {
+    std::vector<uint8_t> indices((size_t)width * height);
+    for (size_t i = 0; i < indices.size(); i++) {
+        indices[i] = (uint8_t)(i % 4);
+    }
+    uint32_t palette[4] = { 0x00000000, 0xFF000000, 0xFFFFFFFF, 0x80FFFFFF };
+
+    AVSubtitleRect rect = {};
+    rect.type = SUBTITLE_BITMAP;
+    rect.x = 0;
+    rect.y = 880;
+    rect.w = width;
+    rect.h = height;
+    rect.nb_colors = 4;
+    rect.data[0] = indices.data();
+    rect.data[1] = (uint8_t*)palette;
+    rect.linesize[0] = width;
+    AVSubtitleRect* rects[] = { &rect };
+
+    AVSubtitle subtitle = {};
+    subtitle.end_display_time = (uint32_t)(duration * 1000);
+    subtitle.num_rects = 1;
+    subtitle.rects = rects;
+    track.AddSubtitle(subtitle, start, 0.0, 1920, 1080);
+}
+
+// 同一事件的位图合计超出图集：最多清空一次，之后只绘制文本，不会每帧重试
+static void CheckUnfittableEvent() {
+    SubtitleEvent event;
+    event.id = 1;
+    event.text = "caption";
+    for (int i = 0; i < 2; i++) {
+        SubtitleBitmap bitmap;
+        bitmap.width = bitmap.pixelWidth = SubtitleCache::kAtlasSize;
+        bitmap.height = bitmap.pixelHeight = SubtitleCache::kAtlasSize * 3 / 4;
+        bitmap.pixels.resize((size_t)bitmap.pixelWidth * bitmap.pixelHeight);
+        event.bitmaps.push_back(std::move(bitmap));
+    }
+    SubtitleEvent small;
+    small.id = 2;
+    SubtitleBitmap bitmap;
+    bitmap.width = bitmap.pixelWidth = 64;
+    bitmap.height = bitmap.pixelHeight = 64;
+    bitmap.pixels.resize(64 * 64);
+    small.bitmaps.push_back(std::move(bitmap));
+
+    SubtitleCache cache;
+    std::vector<const SubtitleEvent*> events = { &small, &event };
+    std::vector<const SubtitleCache::Entry*> entries;
+    PerfSnapshot before = TakePerfSnapshot();
+    for (int frame = 0; frame < 10; frame++) {
+        cache.Prepare(events, entries);
+        CHECK(entries[0] && entries[0]->bitmaps.size() == 1);
+        CHECK(entries[1] && entries[1]->bitmapsFailed && entries[1]->bitmaps.empty());
+        CHECK(entries[1]->lines.size() == 0);  // 未设置排版函数时不排版
+    }
+    PerfSnapshot after = TakePerfSnapshot();
+
+    CHECK(cache.GetAtlasResets() <= 1);
+    CHECK(after.subtitleCacheMisses - before.subtitleCacheMisses == 2);
+    CHECK(after.subtitleCacheHits - before.subtitleCacheHits == 18);
+}
+
+static bool Near(float a, float b) {
+    return std::fabs(a - b) < 0.01f;
+}
+
+// 1920x1080 的帧裁掉上下各 140 行黑边后显示在 1280x533 的区域：
+// 放在黑边里的位图平移回视频区域，内容区的位图位置不变，过大的位图等比缩小
+static void CheckBitmapsInBars() {
+    SubtitleEvent event;
+    event.canvasWidth = 1920;
+    event.canvasHeight = 1080;
+    CropRect crop{ 0, 140, 1920, 800 };
+    SubtitleViewport viewport;
+    viewport.x = 10.0f;
+    viewport.y = 20.0f;
+    viewport.width = 1280.0f;
+    viewport.height = 1280.0f * 800 / 1920;
+    float scale = viewport.width / crop.width;
+    float bottom = viewport.y + viewport.height;
+
+    SubtitleBitmap bitmap;
+    bitmap.x = 560;
+    bitmap.width = 800;
+    bitmap.height = 80;
+
+    // 下黑边：贴住视频区域底边，尺寸不变
+    bitmap.y = 960;
+    SubtitleRect rect = PlaceSubtitleBitmap(bitmap, event, viewport, crop, 1920, 1080);
+    CHECK(Near(rect.y1, bottom));
+    CHECK(Near(rect.y1 - rect.y0, 80 * scale));
+    CHECK(Near(rect.x0, viewport.x + 560 * scale));
+
+    // 上黑边：贴住顶边
+    bitmap.y = 20;
+    rect = PlaceSubtitleBitmap(bitmap, event, viewport, crop, 1920, 1080);
+    CHECK(Near(rect.y0, viewport.y));
+    CHECK(Near(rect.y1 - rect.y0, 80 * scale));
+
+    // 内容区：与未裁剪时的映射一致
+    bitmap.y = 600;
+    rect = PlaceSubtitleBitmap(bitmap, event, viewport, crop, 1920, 1080);
+    CHECK(Near(rect.y0, viewport.y + (600 - 140) * scale));
+
+    // 覆盖整个画布的位图：等比缩小到视频区域高度并保持在区域内
+    bitmap.x = 0;
+    bitmap.y = 0;
+    bitmap.width = 1920;
+    bitmap.height = 1080;
+    rect = PlaceSubtitleBitmap(bitmap, event, viewport, crop, 1920, 1080);
+    CHECK(Near(rect.y1 - rect.y0, viewport.height));
+    CHECK(Near((rect.x1 - rect.x0) / (rect.y1 - rect.y0), 1920.0f / 1080.0f));
+    CHECK(rect.x0 >= viewport.x && rect.x1 <= viewport.x + viewport.width + 0.01f);
+    CHECK(rect.y0 >= viewport.y - 0.01f && rect.y1 <= bottom + 0.01f);
+}
+
+// 合成一个每秒一条两秒 SubRip 字幕的 25fps 文件，经 FFmpegDecoder 逐帧解码并准备叠加，
+// 确认解复用得到的事件完整、文本标签已剥离
+static void RunDecodedFile(int seconds) {
+    TestVideoOptions options;
+    options.width = 320;
+    options.height = 180;
+    options.frameCount = seconds * 25;
+    for (int second = 0; second < seconds; second++) {
+        TestSubtitle subtitle;
+        subtitle.start = second + 0.5;
+        subtitle.duration = 2.0;
+        subtitle.text = "Line " + std::to_string(second) + " <i>styled</i>\nsecond row";
+        options.subtitles.push_back(subtitle);
+    }
+    std::string path = TestFilePath("subtitle_benchmark.mkv");
+    CHECK(WriteTestVideo(path, options));
+
+    FFmpegDecoder decoder;
+    CHECK(decoder.OpenFile(std::wstring(path.begin(), path.end())));
+    int width = 0, height = 0;
+    CHECK(decoder.DecodeFirstFrame(&width, &height));
+
+    SubtitleCache cache;
+    uint64_t layoutCalls = 0;
+    cache.SetLayoutFunction(CountingLayout(&layoutCalls));
+
+    std::vector<const SubtitleEvent*> events;
+    std::vector<const SubtitleCache::Entry*> entries;
+    std::vector<Vertex> vertices;
+    vertices.reserve(4096);
+    PerfSnapshot before = TakePerfSnapshot();
+    uint64_t activeEvents = 0;
+    int frames = 0;
+    double overlayMicros = 0.0;
+
+    do {
+        // 字幕包与视频包交错，解码到当前帧时其显示时间之前的事件都已加入
+        decoder.GetSubtitles().GetActiveEvents(decoder.GetFrameTime(), events);
+        auto start = std::chrono::steady_clock::now();
+        cache.Prepare(events, entries);
+        vertices.clear();
+        for (const SubtitleCache::Entry* entry : entries) {
+            ReplayText(*entry, 0.5f, vertices);
+        }
+        overlayMicros += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        activeEvents += events.size();
+        frames++;
+    } while (decoder.DecodeFrame());
+    PerfSnapshot after = TakePerfSnapshot();
+
+    const SubtitleTrack& track = decoder.GetSubtitles();
+    CHECK(frames == options.frameCount);
+    CHECK(track.GetEventCount() == options.subtitles.size());
+
+    // SubRip 的 <i> 标签经解码器转成 ASS 覆盖标签后被剥离，换行保留
+    track.GetActiveEvents(0.6, events);
+    CHECK(events.size() == 1);
+    CHECK(events[0]->text == "Line 0 styled\nsecond row");
+    CHECK(std::fabs(events[0]->end - events[0]->start - 2.0) < 0.01);
+
+    uint64_t hits = after.subtitleCacheHits - before.subtitleCacheHits;
+    uint64_t misses = after.subtitleCacheMisses - before.subtitleCacheMisses;
+    double hitRate = (double)hits / (double)(hits + misses);
+    std::printf("decoded %zu subtitle events over %d frames, hit rate %.4f, overlay cost %.2f us/frame\n",
+                track.GetEventCount(), frames, hitRate, overlayMicros / frames);
+
+    CHECK(hits + misses == activeEvents);
+    CHECK(hitRate > 0.9);
+    CHECK(layoutCalls == options.subtitles.size() * 2);
+
+    decoder.Cleanup();
+    std::remove(path.c_str());
+}
+
+int main(int argc, char** argv) {
+    CheckUnfittableEvent();
+    CheckBitmapsInBars();
+
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    double contentSeconds = quick ? 60.0 : 600.0;
+
+    // 每秒一条三秒的双行文本（同时约 3 条重叠），每 5 秒一条四秒的位图；
+    // 第 30 秒放一条超出图集的 4096 像素宽位图
+    SubtitleTrack track;
+    int eventCount = 0;
+    for (int second = 0; second < (int)contentSeconds; second++) {
+        AddText(track, second, 3.0, "Line " + std::to_string(second) + " {\\i1}styled{\\i0}\\Nsecond row");
+        eventCount++;
+        if (second % 5 == 0) {
+            AddBitmap(track, second + 0.5, 4.0, 1920, 160);
+            eventCount++;
+        }
+    }
+    AddBitmap(track, 30.25, 2.0, 4096, 300);
+    eventCount++;
+    CHECK((int)track.GetEventCount() == eventCount);
+
+    // 图集的 CPU 副本：上传成本与 UpdateSubresource 的拷贝量相当
+    std::vector<uint32_t> atlas((size_t)SubtitleCache::kAtlasSize * SubtitleCache::kAtlasSize);
+    std::unordered_map<const SubtitleBitmap*, int> uploads;
+    uint64_t uploadedBytes = 0;
+
+    SubtitleCache cache;
+    cache.SetUploadFunction([&](const SubtitleBitmap& bitmap, int x, int y) {
+        CHECK(bitmap.pixelWidth <= SubtitleCache::kAtlasSize && bitmap.pixelHeight <= SubtitleCache::kAtlasSize);
+        for (int row = 0; row < bitmap.pixelHeight; row++) {
+            std::memcpy(&atlas[(size_t)(y + row) * SubtitleCache::kAtlasSize + x],
+                        bitmap.pixels.data() + (size_t)row * bitmap.pixelWidth, (size_t)bitmap.pixelWidth * 4);
+        }
+        uploads[&bitmap]++;
+        uploadedBytes += (uint64_t)bitmap.pixelWidth * bitmap.pixelHeight * 4;
+    });
+    uint64_t layoutCalls = 0;
+    cache.SetLayoutFunction(CountingLayout(&layoutCalls));
+
+    std::vector<const SubtitleEvent*> events;
+    std::vector<const SubtitleCache::Entry*> entries;
+    std::vector<Vertex> vertices;
+    vertices.reserve(4096);
+    uint64_t drawnVertices = 0;
+    PerfSnapshot before = TakePerfSnapshot();
+    uint64_t activeEvents = 0;
+    int frames = (int)(contentSeconds * kFrameRate);
+    bool oversizedDrawn = false;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        track.GetActiveEvents(frame / kFrameRate, events);
+        cache.Prepare(events, entries);
+        activeEvents += events.size();
+
+        for (size_t i = 0; i < events.size(); i++) {
+            CHECK(entries[i] != nullptr);
+            CHECK(!entries[i]->bitmapsFailed);
+            CHECK(entries[i]->bitmaps.size() == events[i]->bitmaps.size());
+            if (!events[i]->bitmaps.empty() && events[i]->bitmaps[0].width == 4096) {
+                oversizedDrawn = true;
+            }
+        }
+
+        vertices.clear();
+        for (const SubtitleCache::Entry* entry : entries) {
+            ReplayText(*entry, 0.75f, vertices);
+        }
+        drawnVertices += vertices.size();
+    }
+    double elapsedMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    PerfSnapshot after = TakePerfSnapshot();
+
+    uint64_t hits = after.subtitleCacheHits - before.subtitleCacheHits;
+    uint64_t misses = after.subtitleCacheMisses - before.subtitleCacheMisses;
+    double hitRate = (double)hits / (double)(hits + misses);
+
+    std::printf("events %d, frames %d, active event-frames %llu\n", eventCount, frames, (unsigned long long)activeEvents);
+    std::printf("cache hits %llu, misses %llu, hit rate %.4f\n",
+                (unsigned long long)hits, (unsigned long long)misses, hitRate);
+    std::printf("atlas resets %llu, uploaded %.1f MB\n",
+                (unsigned long long)cache.GetAtlasResets(), uploadedBytes / (1024.0 * 1024.0));
+    std::printf("text layouts %llu, replayed %.1f vertices/frame\n",
+                (unsigned long long)layoutCalls, (double)drawnVertices / frames);
+    std::printf("overlay cost %.2f us/frame\n", elapsedMicros / frames);
+
+    // 每个可见事件每帧恰好统计一次，图集清空重试不重复计数
+    CHECK(hits + misses == activeEvents);
+    // 文本只在首次出现时排版一次（每条两行），之后每帧回放缓存的四边形
+    CHECK(layoutCalls == (uint64_t)contentSeconds * 2);
+    CHECK(drawnVertices > 0);
+    CHECK(hitRate > 0.9);
+    // 超大位图在加入时已缩小，能正常装入图集并绘制
+    CHECK(oversizedDrawn);
+    // 图集只在装满时清空，每次清空至多让当时可见的位图重传一次
+    CHECK(cache.GetAtlasResets() < (uint64_t)eventCount);
+    for (const auto& upload : uploads) {
+        CHECK(upload.second <= 2);
+    }
+
+    RunDecodedFile(quick ? 20 : 120);
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "test_media.hpp"
+#include <cstring>
+#include <filesystem>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
+}
+
+std::string TestFilePath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("videoplayer_" + name)).string();
+}
+
+AVFrame* CreateTestFrame(const TestVideoOptions& options, int frameIndex) {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(options.pixelFormat);
+    if (!desc || (desc->flags & AV_PIX_FMT_FLAG_RGB) || !(desc->flags & AV_PIX_FMT_FLAG_PLANAR)) {
+        return nullptr;
+    }
+
+    AVFrame* frame = av_frame_alloc();
+    frame->format = options.pixelFormat;
+    frame->width = options.width;
+    frame->height = options.height;
+    if (av_frame_get_buffer(frame, 0) < 0) {
+        av_frame_free(&frame);
+        return nullptr;
+    }
+
+    // 按分量的 step/offset 写入，半平面格式（NV12、P010）的 U、V 交错在同一平面
+    for (int c = 0; c < desc->nb_components && c < 3; c++) {
+        const AVComponentDescriptor& comp = desc->comp[c];
+        int plane = comp.plane;
+        int chroma = (plane == 1 || plane == 2);
+        int planeWidth = chroma ? AV_CEIL_RSHIFT(options.width, desc->log2_chroma_w) : options.width;
+        int planeHeight = chroma ? AV_CEIL_RSHIFT(options.height, desc->log2_chroma_h) : options.height;
+        int barRows = chroma ? (options.barRows >> desc->log2_chroma_h) : options.barRows;
+        int barColumns = chroma ? (options.barColumns >> desc->log2_chroma_w) : options.barColumns;
+        int shift = comp.depth - 8 + comp.shift;
+
+        for (int y = 0; y < planeHeight; y++) {
+            uint8_t* row = frame->data[plane] + (ptrdiff_t)y * frame->linesize[plane];
+            for (int x = 0; x < planeWidth; x++) {
+                bool bar = y < barRows || y >= planeHeight - barRows ||
+                           x < barColumns || x >= planeWidth - barColumns;
+                int value;
+                if (chroma) {
+                    value = bar ? 128 : 96 + (x + (c == 2 ? 17 : 0) + frameIndex) % 64;
+                } else {
+                    value = bar ? 16 : 64 + (x + y + frameIndex * 3) % 136;
+                }
+                value <<= shift;
+                uint8_t* sample = row + (ptrdiff_t)x * comp.step + comp.offset;
+                if (comp.depth > 8) {
+                    *(uint16_t*)sample = (uint16_t)value;
+                } else {
+                    *sample = (uint8_t)value;
+                }
+            }
+        }
+    }
+    return frame;
+}
+
+// 把编码器输出的包全部写入文件
+static bool WriteSubtitle(AVFormatContext* output, AVStream* stream, AVPacket* packet, const TestSubtitle& subtitle) {
+    if (av_new_packet(packet, (int)subtitle.text.size()) < 0) return false;
+    std::memcpy(packet->data, subtitle.text.data(), subtitle.text.size());
+    AVRational milliseconds = { 1, 1000 };
+    packet->pts = av_rescale_q((int64_t)(subtitle.start * 1000), milliseconds, stream->time_base);
+    packet->dts = packet->pts;
+    packet->duration = av_rescale_q((int64_t)(subtitle.duration * 1000), milliseconds, stream->time_base);
+    packet->stream_index = stream->index;
+    packet->flags |= AV_PKT_FLAG_KEY;
+    return av_interleaved_write_frame(output, packet) >= 0;
+}
+
+static bool DrainEncoder(AVCodecContext* encoder, AVFormatContext* output, AVStream* stream, AVPacket* packet) {
+    int ret;
+    while ((ret = avcodec_receive_packet(encoder, packet)) == 0) {
+        av_packet_rescale_ts(packet, encoder->time_base, stream->time_base);
+        packet->stream_index = stream->index;
+        if (av_interleaved_write_frame(output, packet) < 0) {
+            return false;
+        }
+    }
+    return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF;
+}
+
+bool WriteTestVideo(const std::string& path, const TestVideoOptions& options) {
+    AVFormatContext* output = nullptr;
+    if (avformat_alloc_output_context2(&output, NULL, "matroska", path.c_str()) < 0) {
+        return false;
+    }
+
+    AVCodecContext* encoder = nullptr;
+    AVPacket* packet = av_packet_alloc();
+    bool ok = false;
+
+    do {
+        const AVCodec* codec = avcodec_find_encoder(options.bFrames > 0 ? AV_CODEC_ID_MPEG4 : AV_CODEC_ID_FFV1);
+        if (!codec) break;
+
+        AVStream* stream = avformat_new_stream(output, NULL);
+        encoder = avcodec_alloc_context3(codec);
+        encoder->width = options.width;
+        encoder->height = options.height;
+        encoder->pix_fmt = options.pixelFormat;
+        encoder->time_base = AVRational{ 1, 25 };
+        encoder->framerate = AVRational{ 25, 1 };
+        if (options.bFrames > 0) {
+            av_opt_set_int(encoder, "bf", options.bFrames, 0);
+        }
+        if (output->oformat->flags & AVFMT_GLOBALHEADER) {
+            encoder->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        }
+        if (avcodec_open2(encoder, codec, NULL) < 0) break;
+        if (avcodec_parameters_from_context(stream->codecpar, encoder) < 0) break;
+        stream->time_base = encoder->time_base;
+
+        AVStream* subtitleStream = nullptr;
+        if (!options.subtitles.empty()) {
+            subtitleStream = avformat_new_stream(output, NULL);
+            subtitleStream->codecpar->codec_type = AVMEDIA_TYPE_SUBTITLE;
+            subtitleStream->codecpar->codec_id = AV_CODEC_ID_SUBRIP;
+            subtitleStream->time_base = AVRational{ 1, 1000 };
+        }
+
+        if (avio_open(&output->pb, path.c_str(), AVIO_FLAG_WRITE) < 0) break;
+        if (avformat_write_header(output, NULL) < 0) break;
+
+        bool written = true;
+        size_t nextSubtitle = 0;
+        for (int i = 0; i < options.frameCount && written; i++) {
+            // 字幕包按开始时间穿插在视频帧之间写入
+            double frameTime = (double)i * encoder->time_base.num / encoder->time_base.den;
+            while (written && nextSubtitle < options.subtitles.size() &&
+                   options.subtitles[nextSubtitle].start <= frameTime) {
+                written = WriteSubtitle(output, subtitleStream, packet, options.subtitles[nextSubtitle++]);
+            }
+            if (!written) break;
+
+            AVFrame* frame = CreateTestFrame(options, i);
+            if (!frame) {
+                written = false;
+                break;
+            }
+            frame->pts = i;
+            written = avcodec_send_frame(encoder, frame) >= 0 && DrainEncoder(encoder, output, stream, packet);
+            av_frame_free(&frame);
+        }
+        if (!written) break;
+
+        avcodec_send_frame(encoder, NULL);
+        if (!DrainEncoder(encoder, output, stream, packet)) break;
+        ok = av_write_trailer(output) >= 0;
+    } while (false);
+
+    av_packet_free(&packet);
+    if (encoder) avcodec_free_context(&encoder);
+    if (output->pb) avio_closep(&output->pb);
+    avformat_free_context(output);
+    return ok;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavutil/pixfmt.h>
+}
+
+struct AVFrame;
+
+// 一条 SubRip 字幕，时间单位为秒；text 可含换行与 <i> 等 SRT 标签
+struct TestSubtitle {
+    double start = 0.0;
+    double duration = 0.0;
+    std::string text;
+};
+
+struct TestVideoOptions {
+    int width = 320;
+    int height = 240;
+    int frameCount = 10;
+    AVPixelFormat pixelFormat = AV_PIX_FMT_YUV420P;
+    int barRows = 0;     // 上下黑边的行数
+    int barColumns = 0;  // 左右黑边的列数
+    int bFrames = 0;     // 大于 0 时改用带 B 帧的 MPEG-4 编码（仅 YUV420P），解码器会延迟输出
+    std::vector<TestSubtitle> subtitles;  // 非空时另写一条 SubRip 字幕流，按开始时间排序
+};
+
+// 临时目录下的测试文件路径
+std::string TestFilePath(const std::string& name);
+
+// 以 FFV1（无损）编码合成视频写入 path（bFrames > 0 时为 MPEG-4）；仅支持平面 YUV 格式
+// （CreateTestFrame 另支持 NV12、P010 等半平面格式）
+bool WriteTestVideo(const std::string& path, const TestVideoOptions& options);
+
+// 分配并填充一帧合成画面（内容区为亮度渐变，黑边为黑电平），用完以 av_frame_free 释放
+AVFrame* CreateTestFrame(const TestVideoOptions& options, int frameIndex);